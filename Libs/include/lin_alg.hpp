@@ -10,9 +10,15 @@
 
 #pragma once
 
-#include <iostream>
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
+#include "../include/parallel.hpp"
 #include "../include/swap.hpp"
 
 /**
@@ -131,70 +137,548 @@ void gaussElim(T **M, T v[], const int& nRows) {
 }
 
 /**
- * @brief         Solve a linear system of equations in matrix form.
+ * @brief         Blocked LU factorization with partial pivoting.
+ *
+ * Factorizes the `n x n` matrix `A` as P A = L U. `A` is stored contiguously
+ * in row-major order (i.e.: `A[i * n + j]` is the element in row i and column
+ * j). The algorithm is right-looking: a panel of `blockSize` columns is reduced
+ * with the textbook elimination, then the trailing submatrix is updated with a
+ * matrix-matrix product tiled over columns, so that the panel and the current
+ * tile of U stay in L1/L2 cache.
  *
- * @param[in,out] M     The coefficient matrix.
- * @param[in]     v     The constant vector.
- * @param[out]    x     The variable vector.
- * @param[in]     nEqs  The number of equations.
+ * @param[in,out] A          The `n x n` matrix. On exit it contains U in the
+ *                           upper triangle and the multipliers of L (whose
+ *                           diagonal is implicitly 1) below the diagonal.
+ * @param[out]    piv        The pivot indices: at step i, row i was swapped
+ *                           with row `piv[i]`.
+ * @param[in]     n          Size of A.
+ * @param[in]     blockSize  Number of columns of each panel.
  *
- * @tparam        T     Type of the elements in `M` and `v`.
+ * @tparam        T          Type of the elements of `A`.
+ *
+ * @throws        std::runtime_error  Thrown if `A` is singular.
  */
 template <class T>
-void solveLinSystem(T **M, T v[], T x[], const int& nEqs) {
-	// Reduce the system to upper triangular form
-	gaussElim(M, v, nEqs);
+void luDecomposition(T A[], int piv[], const int& n, const int blockSize = 64) {
+	const int tileCols = 256;  // Columns of U updated at once (~L2 sized tile)
+
+	for (int k = 0; k < n; k += blockSize) {
+		const int kb = std::min(blockSize, n - k);
+
+		// Factorize the panel (columns [k, k + kb))
+		for (int j = k; j < k + kb; j++) {
+			int maxI = j;
+			T max    = fabs(A[j * n + j]);
+			for (int i = j + 1; i < n; i++) {
+				T g = fabs(A[i * n + j]);
+				if (g > max) {
+					max  = g;
+					maxI = i;
+				}
+			}
+			if (max == 0.0) throw std::runtime_error("Matrix is singular.");
+
+			piv[j] = maxI;
+			if (maxI != j) {
+				for (int c = 0; c < n; c++) swap(A[j * n + c], A[maxI * n + c]);
+			}
+
+			const T *rowJ = A + j * n;
+			const T inv   = 1.0 / rowJ[j];
+			for (int i = j + 1; i < n; i++) {
+				T *rowI = A + i * n;
+				T g     = rowI[j] *= inv;
+				for (int c = j + 1; c < k + kb; c++) rowI[c] -= g * rowJ[c];
+			}
+		}
 
-	// Solve the system
-	for (int i = nEqs - 1; i >= 0; i--) {
-		T temp = v[i];
-		for (int j = nEqs - 1; j > i; j--) temp -= x[j] * M[i][j];
-		x[i] = temp / M[i][i];
+		if (k + kb == n) break;
+
+		// Compute the block row of U: U12 = L11^-1 A12
+		for (int i = k + 1; i < k + kb; i++) {
+			T *rowI = A + i * n;
+			for (int p = k; p < i; p++) {
+				const T g     = rowI[p];
+				const T *rowP = A + p * n;
+				for (int c = k + kb; c < n; c++) rowI[c] -= g * rowP[c];
+			}
+		}
+
+		// Update the trailing submatrix: A22 -= L21 U12
+		for (int c0 = k + kb; c0 < n; c0 += tileCols) {
+			const int c1 = std::min(c0 + tileCols, n);
+			for (int i = k + kb; i < n; i++) {
+				T *rowI = A + i * n;
+				for (int p = k; p < k + kb; p++) {
+					const T g     = rowI[p];
+					const T *rowP = A + p * n;
+					for (int c = c0; c < c1; c++) rowI[c] -= g * rowP[c];
+				}
+			}
+		}
 	}
 }
 
 /**
- * @brief      Solve a tridiagonal linear system.
+ * @brief      Solve a linear system using the factors of luDecomposition().
+ *
+ * @param[in]  LU    The factorized `n x n` matrix (row-major).
+ * @param[in]  piv   The pivot indices.
+ * @param[in]  v     The constant vector.
+ * @param[out] x     The variable vector. Can be the same array as `v`.
+ * @param[in]  n     The number of equations.
+ *
+ * @tparam     T     Type of the elements in `LU`, `v` and `x`.
+ */
+template <class T>
+void luSolve(const T LU[], const int piv[], const T v[], T x[], const int& n) {
+	if (x != v) {
+		for (int i = 0; i < n; i++) x[i] = v[i];
+	}
+	for (int i = 0; i < n; i++) {
+		if (piv[i] != i) swap(x[i], x[piv[i]]);
+	}
+
+	// Forward substitution (L has unit diagonal)
+	for (int i = 1; i < n; i++) {
+		const T *rowI = LU + i * n;
+		T temp        = x[i];
+		for (int j = 0; j < i; j++) temp -= rowI[j] * x[j];
+		x[i] = temp;
+	}
+
+	// Backsubstitution
+	for (int i = n - 1; i >= 0; i--) {
+		const T *rowI = LU + i * n;
+		T temp        = x[i];
+		for (int j = i + 1; j < n; j++) temp -= rowI[j] * x[j];
+		x[i] = temp / rowI[i];
+	}
+}
+
+/**
+ * @brief      LU factorization of a square matrix, reusable for many solves.
+ *
+ * The matrix is factorized once at construction (O(n^3)), then every call to
+ * solve() costs O(n^2) per right-hand side. The input matrix is not modified.
+ *
+ * @tparam     T     Type of the elements of the matrix.
+ */
+template <class T>
+class LUFactorization {
+  public:
+	/**
+	 * @brief      Constructor (contiguous row-major matrix).
+	 *
+	 * @param[in]  A     The `n x n` matrix, `A[i * n + j]` being the element
+	 *                   in row i and column j.
+	 * @param[in]  n     Size of A.
+	 *
+	 * @throws     std::runtime_error  Thrown if `A` is singular.
+	 */
+	LUFactorization(const T A[], const int& n)
+		: n_(n), lu_(A, A + n * n), piv_(n) {
+		luDecomposition(lu_.data(), piv_.data(), n_);
+	}
+
+	/**
+	 * @brief      Constructor (row-pointer matrix).
+	 *
+	 * @param[in]  M     The `n x n` matrix.
+	 * @param[in]  n     Size of M.
+	 *
+	 * @throws     std::runtime_error  Thrown if `M` is singular.
+	 */
+	LUFactorization(T **M, const int& n) : n_(n), lu_(n * n), piv_(n) {
+		for (int i = 0; i < n_; i++) {
+			for (int j = 0; j < n_; j++) lu_[i * n_ + j] = M[i][j];
+		}
+		luDecomposition(lu_.data(), piv_.data(), n_);
+	}
+
+	/**
+	 * @brief      Solve the system for one right-hand side.
+	 *
+	 * @param[in]  v     The constant vector.
+	 * @param[out] x     The variable vector. Can be the same array as `v`.
+	 */
+	void solve(const T v[], T x[]) const {
+		luSolve(lu_.data(), piv_.data(), v, x, n_);
+	}
+
+	/**
+	 * @overload
+	 *
+	 * @brief      Solve the system for many right-hand sides at once.
+	 *
+	 * The right-hand sides are the columns of the `n x nRhs` row-major matrix
+	 * `V`. Every row operation is applied to all of them in a single
+	 * contiguous loop.
+	 *
+	 * @param[in]  V     The constant vectors (`n x nRhs`, row-major).
+	 * @param[out] X     The variable vectors (`n x nRhs`, row-major). Can be
+	 *                   the same array as `V`.
+	 * @param[in]  nRhs  The number of right-hand sides.
+	 */
+	void solve(const T V[], T X[], const int& nRhs) const {
+		if (X != V) {
+			for (int i = 0; i < n_ * nRhs; i++) X[i] = V[i];
+		}
+		for (int i = 0; i < n_; i++) {
+			if (piv_[i] == i) continue;
+			for (int k = 0; k < nRhs; k++) {
+				swap(X[i * nRhs + k], X[piv_[i] * nRhs + k]);
+			}
+		}
+
+		// Forward substitution (L has unit diagonal)
+		for (int i = 1; i < n_; i++) {
+			T *xI = X + i * nRhs;
+			for (int j = 0; j < i; j++) {
+				const T g   = lu_[i * n_ + j];
+				const T *xJ = X + j * nRhs;
+				for (int k = 0; k < nRhs; k++) xI[k] -= g * xJ[k];
+			}
+		}
+
+		// Backsubstitution
+		for (int i = n_ - 1; i >= 0; i--) {
+			T *xI = X + i * nRhs;
+			for (int j = i + 1; j < n_; j++) {
+				const T g   = lu_[i * n_ + j];
+				const T *xJ = X + j * nRhs;
+				for (int k = 0; k < nRhs; k++) xI[k] -= g * xJ[k];
+			}
+			const T inv = 1.0 / lu_[i * n_ + i];
+			for (int k = 0; k < nRhs; k++) xI[k] *= inv;
+		}
+	}
+
+	/**
+	 * @brief      Returns the size of the factorized matrix.
+	 */
+	int size() const { return n_; }
+
+  private:
+	int n_;                 //!< Size of the matrix
+	std::vector<T> lu_;     //!< L (below the diagonal) and U, row-major
+	std::vector<int> piv_;  //!< Pivot indices
+};
+
+/**
+ * @brief      Solve a linear system of equations in matrix form.
+ *
+ * The matrix is copied to a contiguous buffer and factorized with
+ * luDecomposition(), so `M` and `v` are left untouched.
+ *
+ * @param[in]  M     The coefficient matrix.
+ * @param[in]  v     The constant vector.
+ * @param[out] x     The variable vector.
+ * @param[in]  nEqs  The number of equations.
+ *
+ * @tparam     T     Type of the elements in `M` and `v`.
+ *
+ * @throws     std::runtime_error  Thrown if `M` is singular.
+ */
+template <class T>
+void solveLinSystem(T **M, T v[], T x[], const int& nEqs) {
+	std::vector<T> A(nEqs * nEqs);
+	std::vector<int> piv(nEqs);
+	for (int i = 0; i < nEqs; i++) {
+		for (int j = 0; j < nEqs; j++) A[i * nEqs + j] = M[i][j];
+	}
+
+	luDecomposition(A.data(), piv.data(), nEqs);
+	luSolve(A.data(), piv.data(), v, x, nEqs);
+}
+
+/**
+ * @brief      Solve a tridiagonal linear system (Thomas algorithm).
+ *
+ * The forward sweep stores its coefficients in `work` and in `x`, so no other
+ * memory is needed and there is no limit on the number of equations.
  *
  * @param[in]  a     The array with the elements M[i][i - 1] (sub-diagonal).
  * @param[in]  b     The array with the elements M[i][i] (diagonal).
  * @param[in]  c     The array with the elements M[i][i + 1] (sur-diagonal).
  * @param[in]  r     The constant vector.
- * @param[out] x     The variable vector.
- * @param[in]  nEq   The number of equations
+ * @param[out] x     The variable vector. Can be the same array as `r`.
+ * @param[in]  nEq   The number of equations.
+ * @param[out] work  Workspace of at least `nEq` elements.
  *
  * @tparam     T     Type of the elements in the arrays.
  *
- * @throws     std::invalid_argument  Thrown if nEq > 4096.
  * @throws     std::invalid_argument  Thrown if a[0] isn't NaN.
  * @throws     std::invalid_argument  Thrown if c[-1] isn't NaN.
  */
 template <class T>
-void tridiagonalSolver(T a[], T b[], T c[], T r[], T x[], const int& nEq) {
-	const int maxSize = 4096;
-	if (nEq > maxSize) throw std::invalid_argument("Number of equations must not be greater than " + std::to_string(maxSize) + ".");
-	if (!isnan(a[0])) throw std::invalid_argument("The first element of a must be nan(\"\").");
-	if (!isnan(c[nEq - 1])) throw std::invalid_argument("The last element of c must be nan(\"\").");
-	T h[maxSize], p[maxSize];
+void tridiagonalSolver(const T a[], const T b[], const T c[], const T r[], T x[], const int& nEq, T work[]) {
+	if (!std::isnan(a[0])) throw std::invalid_argument("The first element of a must be nan(\"\").");
+	if (!std::isnan(c[nEq - 1])) throw std::invalid_argument("The last element of c must be nan(\"\").");
+	T *h = work;
 
 	h[0] = c[0] / b[0];
-	p[0] = r[0] / b[0];
+	x[0] = r[0] / b[0];
 
 	// Gaussian elimination
 	for (int i = 1; i < nEq; i++) {
-		T den =  1.0 / (b[i] - a[i] * h[i - 1]);
-		h[i] = c[i] * den;
-		p[i] = (r[i] - a[i] * p[i - 1]) * den;
+		T den = 1.0 / (b[i] - a[i] * h[i - 1]);
+		h[i]  = c[i] * den;
+		x[i]  = (r[i] - a[i] * x[i - 1]) * den;
 	}
 
 	// Backsubsitution
-	x[nEq - 1] = p[nEq - 1];
 	for (int i = nEq - 2; i >= 0; i--) {
-		x[i] = p[i] - h[i] * x[i + 1];
+		x[i] -= h[i] * x[i + 1];
+	}
+}
+
+/**
+ * @overload
+ *
+ * @brief      Solve a tridiagonal linear system (Thomas algorithm).
+ *
+ * @param[in]  a     The array with the elements M[i][i - 1] (sub-diagonal).
+ * @param[in]  b     The array with the elements M[i][i] (diagonal).
+ * @param[in]  c     The array with the elements M[i][i + 1] (sur-diagonal).
+ * @param[in]  r     The constant vector.
+ * @param[out] x     The variable vector.
+ * @param[in]  nEq   The number of equations
+ *
+ * @tparam     T     Type of the elements in the arrays.
+ *
+ * @throws     std::invalid_argument  Thrown if a[0] isn't NaN.
+ * @throws     std::invalid_argument  Thrown if c[-1] isn't NaN.
+ */
+template <class T>
+void tridiagonalSolver(const T a[], const T b[], const T c[], const T r[], T x[], const int& nEq) {
+	std::vector<T> work(nEq);
+	tridiagonalSolver(a, b, c, r, x, nEq, work.data());
+}
+
+/**
+ * @brief         Solve a tridiagonal linear system in place.
+ *
+ * Same as tridiagonalSolver(), but the forward sweep overwrites `c` and `r`,
+ * so no workspace at all is needed.
+ *
+ * @param[in]     a    The array with the elements M[i][i - 1] (sub-diagonal).
+ * @param[in]     b    The array with the elements M[i][i] (diagonal).
+ * @param[in,out] c    The array with the elements M[i][i + 1] (sur-diagonal).
+ *                     Overwritten with the elimination coefficients.
+ * @param[in,out] r    The constant vector. Overwritten with the solution.
+ * @param[in]     nEq  The number of equations.
+ *
+ * @tparam        T    Type of the elements in the arrays.
+ *
+ * @throws        std::invalid_argument  Thrown if a[0] isn't NaN.
+ * @throws        std::invalid_argument  Thrown if c[-1] isn't NaN.
+ */
+template <class T>
+void tridiagonalSolverInPlace(const T a[], const T b[], T c[], T r[], const int& nEq) {
+	tridiagonalSolver(a, b, c, r, r, nEq, c);
+}
+
+/**
+ * @brief      Solve many independent tridiagonal systems of the same size.
+ *
+ * The systems are stored interleaved (structure of arrays): element i of
+ * system s is at index `i * nSys + s` of every array. The Thomas recurrence is
+ * then carried out row by row on all systems at once, and the inner loop over
+ * the systems is contiguous, so each SIMD lane handles a different system.
+ * The systems are split in contiguous groups among `nThreads` threads.
+ *
+ * @param[in]  a         The sub-diagonals (row 0 is ignored).
+ * @param[in]  b         The diagonals.
+ * @param[in]  c         The sur-diagonals (row nEq - 1 is ignored).
+ * @param[in]  r         The constant vectors.
+ * @param[out] x         The variable vectors. Can be the same array as `r`.
+ * @param[in]  nEq       The number of equations of each system.
+ * @param[in]  nSys      The number of systems.
+ * @param[out] work      Workspace of at least `nEq * nSys` elements.
+ * @param[in]  nThreads  The number of threads (see parallelFor()).
+ *
+ * @tparam     T         Type of the elements in the arrays.
+ */
+template <class T>
+void tridiagonalSolverBatch(const T a[], const T b[], const T c[], const T r[], T x[], const int& nEq, const int& nSys, T work[], const int nThreads = 0) {
+	T *h = work;
+
+	auto solve = [&](const int& s0, const int& s1) {
+		for (int s = s0; s < s1; s++) {
+			h[s] = c[s] / b[s];
+			x[s] = r[s] / b[s];
+		}
+
+		// Gaussian elimination
+		for (int i = 1; i < nEq; i++) {
+			const long k = static_cast<long>(i) * nSys;
+			const long l = k - nSys;
+			for (int s = s0; s < s1; s++) {
+				T den    = 1.0 / (b[k + s] - a[k + s] * h[l + s]);
+				h[k + s] = c[k + s] * den;
+				x[k + s] = (r[k + s] - a[k + s] * x[l + s]) * den;
+			}
+		}
+
+		// Backsubstitution
+		for (int i = nEq - 2; i >= 0; i--) {
+			const long k = static_cast<long>(i) * nSys;
+			const long l = k + nSys;
+			for (int s = s0; s < s1; s++) x[k + s] -= h[k + s] * x[l + s];
+		}
+	};
+
+	// Don't split the systems in groups narrower than a cache line
+	const int minGroup = 64 / sizeof(T) > 0 ? 64 / sizeof(T) : 1;
+	int threads        = nThreads > 0 ? nThreads : defaultThreadCount();
+	threads            = std::max(1, std::min(threads, nSys / minGroup));
+	parallelFor(0, nSys, solve, threads);
+}
+
+/**
+ * @overload
+ *
+ * @brief      Solve many independent tridiagonal systems of the same size.
+ *
+ * @param[in]  a         The sub-diagonals (row 0 is ignored).
+ * @param[in]  b         The diagonals.
+ * @param[in]  c         The sur-diagonals (row nEq - 1 is ignored).
+ * @param[in]  r         The constant vectors.
+ * @param[out] x         The variable vectors. Can be the same array as `r`.
+ * @param[in]  nEq       The number of equations of each system.
+ * @param[in]  nSys      The number of systems.
+ * @param[in]  nThreads  The number of threads (see parallelFor()).
+ *
+ * @tparam     T         Type of the elements in the arrays.
+ */
+template <class T>
+void tridiagonalSolverBatch(const T a[], const T b[], const T c[], const T r[], T x[], const int& nEq, const int& nSys, const int nThreads = 0) {
+	std::vector<T> work(static_cast<long>(nEq) * nSys);
+	tridiagonalSolverBatch(a, b, c, r, x, nEq, nSys, work.data(), nThreads);
+}
+
+/**
+ * @brief      Solve a large tridiagonal linear system on many threads.
+ *
+ * Partition (SPIKE) method: the system is cut in `nThreads` blocks of
+ * consecutive rows. Every thread factorizes its own block and solves it for
+ * the local constant vector and for the two "spikes" generated by the
+ * coupling coefficients with the neighbouring blocks. The first and last
+ * unknown of every block then satisfy a small reduced system of 2 * nThreads
+ * equations, which is solved with LUFactorization. Finally every thread
+ * corrects the local solution of its block.
+ *
+ * Systems with less than `minSize` equations are solved with
+ * tridiagonalSolver(), as the three sweeps needed by the partition method are
+ * not worth it without enough rows per thread.
+ *
+ * @param[in]  a         The array with the elements M[i][i - 1] (sub-diagonal).
+ * @param[in]  b         The array with the elements M[i][i] (diagonal).
+ * @param[in]  c         The array with the elements M[i][i + 1] (sur-diagonal).
+ * @param[in]  r         The constant vector.
+ * @param[out] x         The variable vector. Can be the same array as `r`.
+ * @param[in]  nEq       The number of equations.
+ * @param[in]  nThreads  The number of threads (see parallelFor()).
+ * @param[in]  minSize   The minimum number of equations to run in parallel.
+ *
+ * @tparam     T         Type of the elements in the arrays.
+ *
+ * @throws     std::invalid_argument  Thrown if a[0] isn't NaN.
+ * @throws     std::invalid_argument  Thrown if c[-1] isn't NaN.
+ * @throws     std::runtime_error     Thrown if the reduced system is singular.
+ */
+template <class T>
+void tridiagonalSolverParallel(const T a[], const T b[], const T c[], const T r[], T x[], const int& nEq, int nThreads = 0, const int minSize = 1 << 15) {
+	if (nThreads <= 0) nThreads = defaultThreadCount();
+	nThreads = std::min(nThreads, nEq / 2);  // At least 2 rows per block
+	if (nEq < minSize || nThreads < 2) {
+		tridiagonalSolver(a, b, c, r, x, nEq);
+		return;
+	}
+	if (!std::isnan(a[0])) throw std::invalid_argument("The first element of a must be nan(\"\").");
+	if (!std::isnan(c[nEq - 1])) throw std::invalid_argument("The last element of c must be nan(\"\").");
+
+	const int P = nThreads;
+	std::vector<T> h(nEq), v(nEq), w(nEq);  // Elimination coefficients, spikes
+	auto first = [&](const int& k) { return static_cast<int>(static_cast<long long>(nEq) * k / P); };
+
+	// Solve every block for r, for the right spike (c[e - 1] in the last row)
+	// and for the left spike (a[s] in the first row)
+	parallelFor(0, P, [&](const int& k0, const int& k1) {
+		for (int k = k0; k < k1; k++) {
+			const int s = first(k), e = first(k + 1);
+
+			h[s] = c[s] / b[s];
+			x[s] = r[s] / b[s];
+			w[s] = (k > 0) ? a[s] / b[s] : 0.0;
+			T den = 1.0 / b[s];
+			for (int i = s + 1; i < e; i++) {
+				den  = 1.0 / (b[i] - a[i] * h[i - 1]);
+				h[i] = c[i] * den;
+				x[i] = (r[i] - a[i] * x[i - 1]) * den;
+				w[i] = -a[i] * w[i - 1] * den;
+			}
+
+			v[e - 1] = (k < P - 1) ? c[e - 1] * den : 0.0;
+			for (int i = e - 2; i >= s; i--) {
+				x[i] -= h[i] * x[i + 1];
+				w[i] -= h[i] * w[i + 1];
+				v[i] = -h[i] * v[i + 1];
+			}
+		}
+	}, P);
+
+	// Reduced system for the first (2k) and last (2k + 1) unknown of block k:
+	// x_i + v_i * x[first of block k + 1] + w_i * x[last of block k - 1] = y_i
+	const int nRed = 2 * P;
+	std::vector<T> M(nRed * nRed, 0.0), z(nRed);
+	for (int k = 0; k < P; k++) {
+		const int rows[] = {first(k), first(k + 1) - 1};
+		for (int l = 0; l < 2; l++) {
+			const int row = 2 * k + l, i = rows[l];
+			M[row * nRed + row] = 1.0;
+			if (k < P - 1) M[row * nRed + 2 * k + 2] = v[i];
+			if (k > 0) M[row * nRed + 2 * k - 1] = w[i];
+			z[row] = x[i];
+		}
 	}
+	LUFactorization<T>(M.data(), nRed).solve(z.data(), z.data());
+
+	// Correct the local solutions
+	parallelFor(0, P, [&](const int& k0, const int& k1) {
+		for (int k = k0; k < k1; k++) {
+			const int s = first(k), e = first(k + 1);
+			const T xNext = (k < P - 1) ? z[2 * k + 2] : 0.0;
+			const T xPrev = (k > 0) ? z[2 * k - 1] : 0.0;
+			for (int i = s; i < e; i++) x[i] -= v[i] * xNext + w[i] * xPrev;
+		}
+	}, P);
 }
 
 /**
+ * @brief      Solves a linear boundary value problem in the form y'' = f(x).
+ *
+ * The system matrix has constant coefficients (1, -2, 1), so it is never
+ * stored: the right hand side is built directly in `y` and the Thomas
+ * algorithm only needs the `work` array.
+ *
+ * @param[in]  RHS      The Right Hand Side function (i.e.: f(x)).
+ * @param[out] y        The array with the solution of the equation.
+ * @param[in]  xL       The integration starting value.
+ * @param[in]  xR       The integration stopping value.
+ * @param[in]  yL       The left boundary condition.
+ * @param[in]  yR       The right boundary condition.
+ * @param[in]  nPoints  The number of points to use in the integration.
+ * @param[out] work     Workspace of at least `nPoints` elements.
+ *
+ * @throws     std::invalid_argument  Thrown if nPoints < 3.
+ */
+void linearBVP(double (*RHS)(const double& x), double y[], const double& xL, const double& xR, const double& yL, const double& yR, const int& nPoints, double work[]);
+
+/**
+ * @overload
+ *
  * @brief      Solves a linear boundary value problem in the form y'' = f(x).
  *
  * @param[in]  RHS      The Right Hand Side function (i.e.: f(x)).
@@ -205,7 +689,6 @@ void tridiagonalSolver(T a[], T b[], T c[], T r[], T x[], const int& nEq) {
  * @param[in]  yR       The right boundary condition.
  * @param[in]  nPoints  The number of points to use in the integration.
  *
- * @throws     std::invalid_argument  Thrown if nPoints > 4096 (via
- *                                    tridiagonalSolver()).
+ * @throws     std::invalid_argument  Thrown if nPoints < 3.
  */
 void linearBVP(double (*RHS)(const double& x), double y[], const double& xL, const double& xR, const double& yL, const double& yR, const int& nPoints);
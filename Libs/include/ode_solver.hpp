@@ -9,7 +9,16 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include "../include/parallel.hpp"
 
 /**
  * @brief          Euler method step.
@@ -96,3 +105,894 @@ void pVerlet(const double& t, double Y[], void (*RHSFunc)(double Y[], double RHS
  *                      variables) in the system. Must be even.
  */
 void vVerlet(const double& t, double Y[], void (*RHSFunc)(double Y[], double RHS[]), const double& dt, const int& neq);
+
+/**
+ * @brief      ODE stepper with preallocated scratch memory.
+ *
+ * Owns the scratch arrays (intermediate state and stages) needed by the
+ * step methods. They are allocated once, aligned to a cache line, and sized
+ * for `neq` equations, so taking a step never allocates and there is no upper
+ * bound on the number of equations. The free step functions (eulerStep(),
+ * rk4Step(), ...) use one ODEStepper per thread.
+ *
+ * The Right Hand Side can be any callable (function pointer, lambda, functor)
+ * with signature `void(const double& t, double Y[], double RHS[])` (or
+ * `void(double Y[], double RHS[])` for the Verlet methods). Lambdas and
+ * functors can carry the parameters of the problem in their captures, and
+ * the compiler can inline them in the stage loops.
+ */
+class ODEStepper {
+  public:
+	/**
+	 * @brief      Constructor.
+	 *
+	 * @param[in]  neq   The number of equations in the system.
+	 */
+	explicit ODEStepper(const int& neq = 0);
+
+	/**
+	 * @brief      Destructor.
+	 */
+	~ODEStepper();
+
+	ODEStepper(const ODEStepper&)            = delete;
+	ODEStepper& operator=(const ODEStepper&) = delete;
+
+	/**
+	 * @brief      Changes the number of equations.
+	 *
+	 * Memory is reallocated only if `neq` exceeds the current capacity.
+	 *
+	 * @param[in]  neq   The number of equations in the system.
+	 */
+	void resize(const int& neq);
+
+	/**
+	 * @brief      Returns the number of equations in the system.
+	 */
+	int size() const { return neq_; }
+
+	/**
+	 * @brief          Euler method step.
+	 *
+	 * @param[in]      t        The value of time from which to take the step.
+	 * @param[in, out] Y        Array containing all the dependent variables.
+	 * @param[in]      RHSFunc  The Right Hand Sides of the system of equations.
+	 * @param[in]      dt       The step size.
+	 *
+	 * @tparam         RHS      Type of the Right Hand Side callable.
+	 */
+	template <class RHS>
+	void euler(const double& t, double Y[], RHS&& RHSFunc, const double& dt);
+
+	/**
+	 * @brief          Runge-Kutta 2 method step.
+	 *
+	 * @param[in]      t        The value of time from which to take the step.
+	 * @param[in, out] Y        Array containing all the dependent variables.
+	 * @param[in]      RHSFunc  The Right Hand Sides of the system of equations.
+	 * @param[in]      dt       The step size.
+	 * @param[in]      rule     If `false` use Midpoint method (default). If
+	 *                          `true` use Modified Euler method.
+	 *
+	 * @tparam         RHS      Type of the Right Hand Side callable.
+	 */
+	template <class RHS>
+	void rk2(const double& t, double Y[], RHS&& RHSFunc, const double& dt, bool rule = false);
+
+	/**
+	 * @brief          Runge-Kutta 4 method step.
+	 *
+	 * @param[in]      t        The value of time from which to take the step.
+	 * @param[in, out] Y        Array containing all the dependent variables.
+	 * @param[in]      RHSFunc  The Right Hand Sides of the system of equations.
+	 * @param[in]      dt       The step size.
+	 *
+	 * @tparam         RHS      Type of the Right Hand Side callable.
+	 */
+	template <class RHS>
+	void rk4(const double& t, double Y[], RHS&& RHSFunc, const double& dt);
+
+	/**
+	 * @brief          Position Verlet method step.
+	 *
+	 * @param[in]      t        The value of time from which to take the step.
+	 * @param[in, out] Y        Array containing all the dependent variables
+	 *                          (first half positions, second half velocities).
+	 * @param[in]      RHSFunc  The Right Hand Sides of the system of equations.
+	 * @param[in]      dt       The step size.
+	 *
+	 * @tparam         RHS      Type of the Right Hand Side callable.
+	 *
+	 * @throws         std::invalid_argument  Thrown if the number of equations
+	 *                                        is odd.
+	 */
+	template <class RHS>
+	void pVerlet(const double& t, double Y[], RHS&& RHSFunc, const double& dt);
+
+	/**
+	 * @brief          Velocity Verlet method step.
+	 *
+	 * @param[in]      t        The value of time from which to take the step.
+	 * @param[in, out] Y        Array containing all the dependent variables
+	 *                          (first half positions, second half velocities).
+	 * @param[in]      RHSFunc  The Right Hand Sides of the system of equations.
+	 * @param[in]      dt       The step size.
+	 *
+	 * @tparam         RHS      Type of the Right Hand Side callable.
+	 *
+	 * @throws         std::invalid_argument  Thrown if the number of equations
+	 *                                        is odd.
+	 */
+	template <class RHS>
+	void vVerlet(const double& t, double Y[], RHS&& RHSFunc, const double& dt);
+
+  private:
+	static const int nArrays_   = 5;   //!< Number of scratch arrays
+	static const int alignment_ = 64;  //!< Alignment of the scratch arrays
+
+	/**
+	 * @brief      Returns the k-th scratch array.
+	 */
+	double* scratch(const int& k) { return buffer_ + k * stride_; }
+
+	int neq_        = 0;        //!< Number of equations
+	int capacity_   = 0;        //!< Maximum number of equations
+	int stride_     = 0;        //!< Distance between scratch arrays
+	double* buffer_ = nullptr;  //!< Scratch memory
+};
+
+/**
+ * @brief      Scratch ODEStepper for the free step functions.
+ *
+ * Takes an ODEStepper from a pool owned by the calling thread, resized to
+ * `neq`, and gives it back when destroyed. The pool holds one stepper per
+ * nesting depth: when the Right Hand Side of a step calls a free step
+ * function itself, the nested step takes the next stepper, so it never
+ * touches the scratch of the outer one. Memory is only allocated the first
+ * time a depth is reached or a larger system is seen at that depth.
+ */
+class LocalStepper {
+  public:
+	/**
+	 * @brief      Constructor.
+	 *
+	 * @param[in]  neq   The number of equations in the system.
+	 */
+	explicit LocalStepper(const int& neq);
+
+	/**
+	 * @brief      Destructor. Gives the stepper back to the pool.
+	 */
+	~LocalStepper();
+
+	LocalStepper(const LocalStepper&)            = delete;
+	LocalStepper& operator=(const LocalStepper&) = delete;
+
+	/**
+	 * @brief      Access to the stepper.
+	 */
+	ODEStepper* operator->() const { return stepper_; }
+
+  private:
+	ODEStepper* stepper_;  //!< The stepper in use
+};
+
+/**
+ * @overload
+ *
+ * @brief          Euler method step (any callable).
+ *
+ * @param[in]      t        The value of time from which to take the step.
+ * @param[in, out] Y        Array containing all the dependent variables.
+ * @param[in]      RHSFunc  The Right Hand Sides of the system of equations.
+ * @param[in]      dt       The step size.
+ * @param[in]      neq      The number of equations in the system.
+ *
+ * @tparam         RHS      Type of the Right Hand Side callable.
+ */
+template <class RHS>
+void eulerStep(const double& t, double Y[], RHS&& RHSFunc, const double& dt, const int& neq) {
+	LocalStepper(neq)->euler(t, Y, RHSFunc, dt);
+}
+
+/**
+ * @overload
+ *
+ * @brief          Runge-Kutta 2 method step (any callable).
+ *
+ * @param[in]      t        The value of time from which to take the step.
+ * @param[in, out] Y        Array containing all the dependent variables.
+ * @param[in]      RHSFunc  The Right Hand Sides of the system of equations.
+ * @param[in]      dt       The step size.
+ * @param[in]      neq      The number of equations in the system.
+ * @param[in]      rule     If `false` use Midpoint method (default). If `true`
+ *                          use Modified Euler method.
+ *
+ * @tparam         RHS      Type of the Right Hand Side callable.
+ */
+template <class RHS>
+void rk2Step(const double& t, double Y[], RHS&& RHSFunc, const double& dt, const int& neq, bool rule = false) {
+	LocalStepper(neq)->rk2(t, Y, RHSFunc, dt, rule);
+}
+
+/**
+ * @overload
+ *
+ * @brief          Runge-Kutta 4 method step (any callable).
+ *
+ * @param[in]      t        The value of time from which to take the step.
+ * @param[in, out] Y        Array containing all the dependent variables.
+ * @param[in]      RHSFunc  The Right Hand Sides of the system of equations.
+ * @param[in]      dt       The step size.
+ * @param[in]      neq      The number of equations in the system.
+ *
+ * @tparam         RHS      Type of the Right Hand Side callable.
+ */
+template <class RHS>
+void rk4Step(const double& t, double Y[], RHS&& RHSFunc, const double& dt, const int& neq) {
+	LocalStepper(neq)->rk4(t, Y, RHSFunc, dt);
+}
+
+/**
+ * @overload
+ *
+ * @brief          Position Verlet method step (any callable).
+ *
+ * @param[in]      t        The value of time from which to take the step.
+ * @param[in, out] Y        Array containing all the dependent variables.
+ * @param[in]      RHSFunc  The Right Hand Sides of the system of equations.
+ * @param[in]      dt       The step size.
+ * @param[in]      neq      The number of equations in the system. Must be even.
+ *
+ * @tparam         RHS      Type of the Right Hand Side callable.
+ */
+template <class RHS>
+void pVerlet(const double& t, double Y[], RHS&& RHSFunc, const double& dt, const int& neq) {
+	LocalStepper(neq)->pVerlet(t, Y, RHSFunc, dt);
+}
+
+/**
+ * @overload
+ *
+ * @brief          Velocity Verlet method step (any callable).
+ *
+ * @param[in]      t        The value of time from which to take the step.
+ * @param[in, out] Y        Array containing all the dependent variables.
+ * @param[in]      RHSFunc  The Right Hand Sides of the system of equations.
+ * @param[in]      dt       The step size.
+ * @param[in]      neq      The number of equations in the system. Must be even.
+ *
+ * @tparam         RHS      Type of the Right Hand Side callable.
+ */
+template <class RHS>
+void vVerlet(const double& t, double Y[], RHS&& RHSFunc, const double& dt, const int& neq) {
+	LocalStepper(neq)->vVerlet(t, Y, RHSFunc, dt);
+}
+
+template <class RHS>
+void ODEStepper::euler(const double& t, double Y[], RHS&& RHSFunc, const double& dt) {
+	double *rhs = scratch(0);
+
+	RHSFunc(t, Y, rhs);
+	for (int i = 0; i < neq_; i++) Y[i] += dt * rhs[i];
+}
+
+template <class RHS>
+void ODEStepper::rk2(const double& t, double Y[], RHS&& RHSFunc, const double& dt, bool rule) {
+	double *Ystar = scratch(0), *k1 = scratch(1), *k2 = scratch(2);
+
+	if (!rule) {
+		// Midpoint
+		RHSFunc(t, Y, k1);
+
+		for (int i = 0; i < neq_; i++) Ystar[i] = Y[i] + 0.5 * dt * k1[i];
+		RHSFunc(t + 0.5 * dt, Ystar, k2);
+
+		for (int i = 0; i < neq_; i++) Y[i] += dt * k2[i];
+	} else {
+		// Modified Euler
+		RHSFunc(t, Y, k1);
+
+		for (int i = 0; i < neq_; i++) Ystar[i] = Y[i] + dt * k1[i];
+		RHSFunc(t + dt, Ystar, k2);
+
+		for (int i = 0; i < neq_; i++) Y[i] += dt * 0.5 * (k1[i] + k2[i]);
+	}
+}
+
+template <class RHS>
+void ODEStepper::rk4(const double& t, double Y[], RHS&& RHSFunc, const double& dt) {
+	double *Ystar = scratch(0), *k1 = scratch(1), *k2 = scratch(2), *k3 = scratch(3), *k4 = scratch(4);
+
+	RHSFunc(t, Y, k1);
+
+	for (int i = 0; i < neq_; i++) Ystar[i] = Y[i] + 0.5 * dt * k1[i];
+	RHSFunc(t + 0.5 * dt, Ystar, k2);
+
+	for (int i = 0; i < neq_; i++) Ystar[i] = Y[i] + 0.5 * dt * k2[i];
+	RHSFunc(t + 0.5 * dt, Ystar, k3);
+
+	for (int i = 0; i < neq_; i++) Ystar[i] = Y[i] + dt * k3[i];
+	RHSFunc(t + dt, Ystar, k4);
+
+	for (int i = 0; i < neq_; i++)
+		Y[i] += dt / 6.0 * (k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + k4[i]);
+}
+
+template <class RHS>
+void ODEStepper::pVerlet(const double& t, double Y[], RHS&& RHSFunc, const double& dt) {
+	if (neq_ % 2 != 0) throw std::invalid_argument("nEq must be even");
+
+	double *a = scratch(0);
+
+	int nParticles = neq_ / 2;
+
+	double *x = Y;
+	double *v = Y + nParticles;
+
+	for (int i = 0; i < nParticles; i++) x[i] += 0.5 * dt * v[i];
+
+	RHSFunc(Y, a);
+
+	for (int i = 0; i < nParticles; i++) {
+		// Note: index of a is the index of the velocities
+		v[i] += dt * (a + nParticles)[i];
+		x[i] += 0.5 * dt * v[i];
+	}
+}
+
+template <class RHS>
+void ODEStepper::vVerlet(const double& t, double Y[], RHS&& RHSFunc, const double& dt) {
+	if (neq_ % 2 != 0) throw std::invalid_argument("nEq must be even");
+
+	double *a = scratch(0);
+
+	int nParticles = neq_ / 2;
+
+	double *x = Y;
+	double *v = Y + nParticles;
+
+	RHSFunc(Y, a);
+
+	for (int i = 0; i < nParticles; i++) {
+		// Note: index of a is the index of the velocities
+		v[i] += 0.5 * dt * (a + nParticles)[i];
+		x[i] += dt * v[i];
+	}
+
+	RHSFunc(Y, a);
+
+	for (int i = 0; i < nParticles; i++) {
+		// Note: index of a is the index of the velocities
+		v[i] += 0.5 * dt * (a + nParticles)[i];
+	}
+}
+
+/**
+ * @brief      Adaptive Dormand-Prince 5(4) integrator.
+ *
+ * Embedded Runge-Kutta pair of order 5 (used to advance the solution) and 4
+ * (used to estimate the local error). The step size is chosen by a PI
+ * controller so that the error, measured component by component against
+ * `atol + rtol * |Y_i|`, stays below 1. The last stage of an accepted step is
+ * the first stage of the next one (First Same As Last), so every accepted
+ * step costs 6 evaluations of the Right Hand Side.
+ *
+ * After every accepted step the 4th order continuous extension of the method
+ * is available through denseOutput(), so the solution can be evaluated
+ * anywhere inside the last step without further evaluations of the Right Hand
+ * Side.
+ *
+ * Events are zero crossings of user functions `g(t, Y)` registered with
+ * addEvent(). integrate() checks them after every accepted step and locates
+ * each crossing on the continuous extension, so the step size is never reduced
+ * to hit an event. An event can stop the integration after a given number of
+ * occurrences.
+ *
+ * The Right Hand Side can be any callable with signature
+ * `void(const double& t, double Y[], double RHS[])`.
+ */
+class DormandPrince {
+  public:
+	/**
+	 * @brief      Event function, with signature `double(t, Y)`.
+	 */
+	using EventFunc = std::function<double(const double& t, const double Y[])>;
+
+	/**
+	 * @brief      An occurrence of an event.
+	 */
+	struct EventHit {
+		int id;                 //!< The id returned by addEvent()
+		double t;               //!< The time of the zero crossing
+		std::vector<double> Y;  //!< The dependent variables at time `t`
+	};
+
+	/**
+	 * @brief      Constructor.
+	 *
+	 * @param[in]  neq   The number of equations in the system.
+	 * @param[in]  atol  The absolute tolerance.
+	 * @param[in]  rtol  The relative tolerance.
+	 */
+	DormandPrince(const int& neq, const double& atol = 1.0e-8, const double& rtol = 1.0e-8);
+
+	/**
+	 * @brief          Integrates the system from t to tEnd.
+	 *
+	 * @param[in]      RHSFunc  The Right Hand Sides of the system of equations.
+	 * @param[in, out] t        The initial time. On exit it is equal to `tEnd`,
+	 *                          or to the time of the event that stopped the
+	 *                          integration.
+	 * @param[in, out] Y        Array with the dependent variables at time `t`.
+	 * @param[in]      tEnd     The final time. Can be smaller than `t`.
+	 *
+	 * @tparam         RHS      Type of the Right Hand Side callable.
+	 *
+	 * @return         The number of accepted steps.
+	 *
+	 * @throws         std::runtime_error  Thrown if the maximum number of steps
+	 *                                     is exceeded.
+	 * @throws         std::runtime_error  Thrown if the step size becomes too
+	 *                                     small.
+	 */
+	template <class RHS>
+	int integrate(RHS&& RHSFunc, double& t, double Y[], const double& tEnd);
+
+	/**
+	 * @brief          Takes one accepted step towards tEnd.
+	 *
+	 * Rejected attempts are repeated with a smaller step size. The step never
+	 * goes past `tEnd`. `start()` must be called before the first step.
+	 *
+	 * @param[in]      RHSFunc  The Right Hand Sides of the system of equations.
+	 * @param[in, out] t        The current time. Advanced by the step.
+	 * @param[in, out] Y        Array with the dependent variables at time `t`.
+	 * @param[in]      tEnd     The time that must not be overstepped.
+	 *
+	 * @tparam         RHS      Type of the Right Hand Side callable.
+	 *
+	 * @throws         std::runtime_error  Thrown if the step size becomes too
+	 *                                     small.
+	 */
+	template <class RHS>
+	void step(RHS&& RHSFunc, double& t, double Y[], const double& tEnd);
+
+	/**
+	 * @brief      Prepares a new integration from (t, Y).
+	 *
+	 * Evaluates the Right Hand Side at the initial point and, if no step size
+	 * was set with setStepSize(), estimates a starting step size.
+	 *
+	 * @param[in]  RHSFunc  The Right Hand Sides of the system of equations.
+	 * @param[in]  t        The initial time.
+	 * @param[in]  Y        Array with the dependent variables at time `t`.
+	 * @param[in]  tEnd     The final time (used for the direction of
+	 *                      integration).
+	 *
+	 * @tparam     RHS      Type of the Right Hand Side callable.
+	 */
+	template <class RHS>
+	void start(RHS&& RHSFunc, const double& t, double Y[], const double& tEnd);
+
+	/**
+	 * @brief      Evaluates the solution inside the last accepted step.
+	 *
+	 * Uses the 4th order continuous extension of the Dormand-Prince method
+	 * (Hairer, Norsett, Wanner, Solving ODEs I, II.6).
+	 *
+	 * @param[in]  t     The time, between stepStart() and stepEnd().
+	 * @param[out] Y     Array with the dependent variables at time `t`.
+	 *
+	 * @throws     std::invalid_argument  Thrown if `t` is outside the last
+	 *                                    step.
+	 * @throws     std::runtime_error     Thrown if no step has been taken yet.
+	 */
+	void denseOutput(const double& t, double Y[]) const;
+
+	/**
+	 * @overload
+	 *
+	 * @brief      Evaluates one component of the solution inside the last
+	 *             accepted step.
+	 *
+	 * @param[in]  t     The time, between stepStart() and stepEnd().
+	 * @param[in]  i     The index of the component.
+	 *
+	 * @return     The i-th dependent variable at time `t`.
+	 *
+	 * @throws     std::invalid_argument  Thrown if `t` is outside the last
+	 *                                    step.
+	 * @throws     std::runtime_error     Thrown if no step has been taken yet.
+	 */
+	double denseOutput(const double& t, const int& i) const;
+
+	/**
+	 * @brief      Registers an event function.
+	 *
+	 * An event occurs when `g(t, Y(t))` changes sign. Only one crossing per
+	 * event function is detected in each step, so `g` should not change sign
+	 * twice on the scale of a step.
+	 *
+	 * @param[in]  g          The event function.
+	 * @param[in]  direction  0 to detect every crossing, +1 only crossings
+	 *                        from negative to positive, -1 only crossings from
+	 *                        positive to negative.
+	 * @param[in]  stopAfter  Number of occurrences after which integrate()
+	 *                        stops (0 to never stop).
+	 *
+	 * @return     The id of the event.
+	 */
+	int addEvent(const EventFunc& g, const int& direction = 0, const int& stopAfter = 0);
+
+	/**
+	 * @brief      Removes all the event functions.
+	 */
+	void clearEvents();
+
+	/**
+	 * @brief      Returns the number of occurrences of an event in the last
+	 *             call to integrate().
+	 *
+	 * @param[in]  id    The id returned by addEvent().
+	 */
+	int eventCount(const int& id) const;
+
+	/**
+	 * @brief      Returns the occurrences of all the events in the last call to
+	 *             integrate(), sorted by time.
+	 */
+	const std::vector<EventHit>& eventLog() const { return eventLog_; }
+
+	/**
+	 * @brief      Returns whether the last call to integrate() was stopped by
+	 *             an event.
+	 */
+	bool stopped() const { return stopped_; }
+
+	/**
+	 * @brief      Returns the time at the start of the last accepted step.
+	 */
+	double stepStart() const { return tOld_; }
+
+	/**
+	 * @brief      Returns the time at the end of the last accepted step.
+	 */
+	double stepEnd() const { return tNew_; }
+
+	/**
+	 * @brief      Sets the size of the next step (0 to estimate it).
+	 */
+	void setStepSize(const double& h) { h_ = fabs(h); }
+
+	/**
+	 * @brief      Sets the maximum number of steps taken by integrate().
+	 */
+	void setMaxSteps(const int& maxSteps) { maxSteps_ = maxSteps; }
+
+	/**
+	 * @brief      Returns the size of the next step.
+	 */
+	double stepSize() const { return h_; }
+
+	/**
+	 * @brief      Returns the number of Right Hand Side evaluations.
+	 */
+	long nEval() const { return nEval_; }
+
+	/**
+	 * @brief      Returns the number of accepted steps.
+	 */
+	long nAccepted() const { return nAccepted_; }
+
+	/**
+	 * @brief      Returns the number of rejected steps.
+	 */
+	long nRejected() const { return nRejected_; }
+
+  private:
+	/**
+	 * @brief      Returns the RMS norm of the error of the last attempt.
+	 *
+	 * @param[in]  Y     The dependent variables at the start of the step.
+	 */
+	double errorNorm(const double Y[]) const;
+
+	/**
+	 * @brief      Returns the continuous extension at theta in [0, 1].
+	 */
+	double interpolate(const double& theta, const int& i) const;
+
+	/**
+	 * @brief      Evaluates the event functions at the start of an integration.
+	 */
+	void initEvents(const double& t, const double Y[]);
+
+	/**
+	 * @brief          Looks for events in the last accepted step.
+	 *
+	 * @param[in, out] t     The time at the end of the step. Moved back to the
+	 *                       stopping event, if any.
+	 * @param[in, out] Y     The dependent variables at time `t`.
+	 *
+	 * @return         Whether an event stopped the integration.
+	 */
+	bool checkEvents(double& t, double Y[]);
+
+	/**
+	 * @brief      Locates the zero of an event function in the last step.
+	 *
+	 * On exit yEvent_ holds the dependent variables at the returned point.
+	 *
+	 * @param[in]  id    The id of the event.
+	 * @param[in]  gOld  The event function at the start of the step.
+	 * @param[in]  gNew  The event function at the end of the step (non-zero,
+	 *                   with opposite sign).
+	 *
+	 * @return     The position in the step, theta in (0, 1], just past the
+	 *             crossing.
+	 */
+	double locateEvent(const int& id, double gOld, double gNew);
+
+	/**
+	 * @brief      Returns the k-th stage array (k = 0, ..., 6).
+	 */
+	double* k(const int& i) { return k_.data() + i * neq_; }
+
+	int neq_;                   //!< Number of equations
+	double atol_;               //!< Absolute tolerance
+	double rtol_;               //!< Relative tolerance
+	double h_       = 0.0;      //!< Size of the next step
+	double errOld_  = 1e-4;     //!< Error of the last accepted step
+	int maxSteps_   = 1000000;  //!< Maximum number of steps in integrate()
+	long nEval_     = 0;        //!< Number of RHS evaluations
+	long nAccepted_ = 0;        //!< Number of accepted steps
+	long nRejected_ = 0;        //!< Number of rejected steps
+	double tOld_    = 0.0;      //!< Start of the last accepted step
+	double tNew_    = 0.0;      //!< End of the last accepted step
+	bool hasStep_   = false;    //!< Whether a step has been accepted
+	std::vector<double> k_;     //!< Stages
+	std::vector<double> cont_;  //!< Coefficients of the continuous extension
+	std::vector<double> yNew_;  //!< Solution at the end of the step
+	std::vector<double> yErr_;  //!< Error estimate
+
+	/**
+	 * @brief      A registered event function.
+	 */
+	struct Event {
+		EventFunc g;    //!< Event function
+		int direction;  //!< Direction of the crossings to detect
+		int stopAfter;  //!< Occurrences that stop the integration
+		int count;      //!< Occurrences in the current integration
+		double gOld;    //!< Value at the start of the current step
+	};
+
+	std::vector<Event> events_;       //!< Event functions
+	std::vector<EventHit> eventLog_;  //!< Occurrences of the events
+	std::vector<double> yEvent_;      //!< Scratch for the event search
+	bool stopped_ = false;            //!< Whether an event stopped integrate()
+};
+
+template <class RHS>
+int DormandPrince::integrate(RHS&& RHSFunc, double& t, double Y[], const double& tEnd) {
+	start(RHSFunc, t, Y, tEnd);
+	initEvents(t, Y);
+
+	int nSteps = 0;
+	while (t != tEnd) {
+		if (nSteps >= maxSteps_) throw std::runtime_error("Maximum number of steps exceeded.");
+		step(RHSFunc, t, Y, tEnd);
+		nSteps++;
+		if (!events_.empty() && checkEvents(t, Y)) break;
+	}
+	return nSteps;
+}
+
+template <class RHS>
+void DormandPrince::start(RHS&& RHSFunc, const double& t, double Y[], const double& tEnd) {
+	RHSFunc(t, Y, k(0));
+	nEval_++;
+	errOld_ = 1e-4;
+	if (h_ > 0.0) return;
+
+	// Initial step size (Hairer, Norsett, Wanner, Solving ODEs I, II.4)
+	const double dir = (tEnd >= t) ? 1.0 : -1.0;
+	double d0 = 0.0, d1 = 0.0;
+	for (int i = 0; i < neq_; i++) {
+		const double sc = atol_ + rtol_ * fabs(Y[i]);
+		d0 += (Y[i] / sc) * (Y[i] / sc);
+		d1 += (k(0)[i] / sc) * (k(0)[i] / sc);
+	}
+	double h0 = (d0 < 1e-10 || d1 < 1e-10) ? 1e-6 : 0.01 * sqrt(d0 / d1);
+	h0 = std::min(h0, fabs(tEnd - t));
+
+	for (int i = 0; i < neq_; i++) yNew_[i] = Y[i] + dir * h0 * k(0)[i];
+	RHSFunc(t + dir * h0, yNew_.data(), k(1));
+	nEval_++;
+
+	double d2 = 0.0;
+	for (int i = 0; i < neq_; i++) {
+		const double sc = atol_ + rtol_ * fabs(Y[i]);
+		d2 += ((k(1)[i] - k(0)[i]) / sc) * ((k(1)[i] - k(0)[i]) / sc);
+	}
+	d2 = sqrt(d2 / neq_) / h0;
+	d1 = sqrt(d1 / neq_);
+
+	const double dMax = std::max(d1, d2);
+	const double h1   = (dMax <= 1e-15) ? std::max(1e-6, 1e-3 * h0) : pow(0.01 / dMax, 0.2);
+	h_ = std::min(100.0 * h0, h1);
+}
+
+template <class RHS>
+void DormandPrince::step(RHS&& RHSFunc, double& t, double Y[], const double& tEnd) {
+	// Butcher tableau
+	static const double c2 = 1.0 / 5.0, c3 = 3.0 / 10.0, c4 = 4.0 / 5.0, c5 = 8.0 / 9.0;
+	static const double a21 = 1.0 / 5.0;
+	static const double a31 = 3.0 / 40.0, a32 = 9.0 / 40.0;
+	static const double a41 = 44.0 / 45.0, a42 = -56.0 / 15.0, a43 = 32.0 / 9.0;
+	static const double a51 = 19372.0 / 6561.0, a52 = -25360.0 / 2187.0, a53 = 64448.0 / 6561.0, a54 = -212.0 / 729.0;
+	static const double a61 = 9017.0 / 3168.0, a62 = -355.0 / 33.0, a63 = 46732.0 / 5247.0, a64 = 49.0 / 176.0, a65 = -5103.0 / 18656.0;
+	static const double a71 = 35.0 / 384.0, a73 = 500.0 / 1113.0, a74 = 125.0 / 192.0, a75 = -2187.0 / 6784.0, a76 = 11.0 / 84.0;
+	static const double d1 = -12715105075.0 / 11282082432.0, d3 = 87487479700.0 / 32700410799.0, d4 = -10690763975.0 / 1880347072.0;
+	static const double d5 = 701980252875.0 / 199316789632.0, d6 = -1453857185.0 / 822651844.0, d7 = 69997945.0 / 29380423.0;
+	static const double e1 = 71.0 / 57600.0, e3 = -71.0 / 16695.0, e4 = 71.0 / 1920.0, e5 = -17253.0 / 339200.0, e6 = 22.0 / 525.0, e7 = -1.0 / 40.0;
+
+	// Step size controller
+	static const double safe = 0.9, facMin = 0.2, facMax = 10.0, beta = 0.04;
+	static const double alpha = 0.2 - 0.75 * beta;
+
+	const double dir = (tEnd >= t) ? 1.0 : -1.0;
+	double *k1 = k(0), *k2 = k(1), *k3 = k(2), *k4 = k(3), *k5 = k(4), *k6 = k(5), *k7 = k(6);
+	double *y = yNew_.data();
+
+	while (true) {
+		bool last = false;
+		if (h_ >= fabs(tEnd - t)) {
+			h_   = fabs(tEnd - t);
+			last = true;
+		}
+		const double h = dir * h_;
+
+		// Relative to the larger end, so that the check also works at t = 0
+		const double tScale = std::max(fabs(t), fabs(tEnd));
+		if (fabs(h) <= 10.0 * tScale * 2.2e-16 && !last) throw std::runtime_error("Step size too small.");
+
+		for (int i = 0; i < neq_; i++) y[i] = Y[i] + h * a21 * k1[i];
+		RHSFunc(t + c2 * h, y, k2);
+		for (int i = 0; i < neq_; i++) y[i] = Y[i] + h * (a31 * k1[i] + a32 * k2[i]);
+		RHSFunc(t + c3 * h, y, k3);
+		for (int i = 0; i < neq_; i++) y[i] = Y[i] + h * (a41 * k1[i] + a42 * k2[i] + a43 * k3[i]);
+		RHSFunc(t + c4 * h, y, k4);
+		for (int i = 0; i < neq_; i++) y[i] = Y[i] + h * (a51 * k1[i] + a52 * k2[i] + a53 * k3[i] + a54 * k4[i]);
+		RHSFunc(t + c5 * h, y, k5);
+		for (int i = 0; i < neq_; i++) y[i] = Y[i] + h * (a61 * k1[i] + a62 * k2[i] + a63 * k3[i] + a64 * k4[i] + a65 * k5[i]);
+		RHSFunc(t + h, y, k6);
+		for (int i = 0; i < neq_; i++) y[i] = Y[i] + h * (a71 * k1[i] + a73 * k3[i] + a74 * k4[i] + a75 * k5[i] + a76 * k6[i]);
+		const double tNew = last ? tEnd : t + h;
+		RHSFunc(tNew, y, k7);
+		nEval_ += 6;
+
+		for (int i = 0; i < neq_; i++) yErr_[i] = h * (e1 * k1[i] + e3 * k3[i] + e4 * k4[i] + e5 * k5[i] + e6 * k6[i] + e7 * k7[i]);
+		const double err = errorNorm(Y);
+
+		// PI controller
+		const double fac11 = pow(err, alpha);
+		if (err <= 1.0) {
+			double fac = fac11 / pow(errOld_, beta) / safe;
+			fac        = std::max(1.0 / facMax, std::min(1.0 / facMin, fac));
+			errOld_    = std::max(err, 1e-4);
+
+			// Coefficients of the continuous extension
+			double *r1 = cont_.data(), *r2 = r1 + neq_, *r3 = r2 + neq_, *r4 = r3 + neq_, *r5 = r4 + neq_;
+			for (int i = 0; i < neq_; i++) {
+				const double yDiff = y[i] - Y[i];
+				const double bSpl  = h * k1[i] - yDiff;
+				r1[i] = Y[i];
+				r2[i] = yDiff;
+				r3[i] = bSpl;
+				r4[i] = yDiff - h * k7[i] - bSpl;
+				r5[i] = h * (d1 * k1[i] + d3 * k3[i] + d4 * k4[i] + d5 * k5[i] + d6 * k6[i] + d7 * k7[i]);
+			}
+			tOld_    = t;
+			tNew_    = tNew;
+			hasStep_ = true;
+
+			// Accept the step; k7 is the first stage of the next step (FSAL)
+			t = tNew;
+			for (int i = 0; i < neq_; i++) {
+				Y[i]  = y[i];
+				k1[i] = k7[i];
+			}
+			h_ = h_ / fac;
+			nAccepted_++;
+			return;
+		}
+
+		// Reject the step
+		if (std::isnan(err)) h_ *= facMin;
+		else h_ = h_ / std::min(1.0 / facMin, fac11 / safe);
+		nRejected_++;
+	}
+}
+
+/**
+ * @brief          Integrates an ensemble of trajectories with RK4.
+ *
+ * Advances `nTraj` independent trajectories of the same system by `nSteps`
+ * fixed steps. The ensemble is stored in Structure of Arrays layout: component
+ * i of trajectory j is `Y[i * nTraj + j]`. Trajectories are processed in blocks
+ * of `blockSize`, which are copied to contiguous buffers and advanced through
+ * all the steps before moving to the next block, so that the stage arithmetic
+ * runs over contiguous arrays and blocks are distributed among threads.
+ *
+ * Every trajectory takes the same steps as `nSteps` calls to rk4Step().
+ *
+ * @param[in]      t          The initial time.
+ * @param[in, out] Y          Array with the dependent variables of all the
+ *                            trajectories (`neq * nTraj` elements).
+ * @param[in]      RHSFunc    The Right Hand Sides, evaluated on a block of
+ *                            trajectories at once.
+ * @param[in]      dt         The step size.
+ * @param[in]      nSteps     The number of steps.
+ * @param[in]      neq        The number of equations of each trajectory.
+ * @param[in]      nTraj      The number of trajectories.
+ * @param[in]      nThreads   The number of threads. If `nThreads <= 0`,
+ *                            defaultThreadCount() is used.
+ * @param[in]      blockSize  The number of trajectories in a block.
+ *
+ * @tparam         RHS        Any callable with signature
+ *                            `void(const double& t, double Y[], double RHS[], const int& n)`,
+ *                            where `Y` and `RHS` hold a block of `n`
+ *                            trajectories in the same layout as the ensemble
+ *                            (`Y[i * n + j]`). Parameters that differ between
+ *                            trajectories can be carried as components with
+ *                            zero derivative.
+ *
+ * @throws         std::invalid_argument  Thrown if `neq`, `nTraj` or
+ *                                        `blockSize` is not positive.
+ */
+template <class RHS>
+void rk4Ensemble(const double& t, double Y[], RHS&& RHSFunc, const double& dt, const int& nSteps, const int& neq,
+                 const int& nTraj, const int nThreads = 0, const int blockSize = 256) {
+	if (neq <= 0 || nTraj <= 0) throw std::invalid_argument("neq and nTraj must be positive");
+	if (blockSize <= 0) throw std::invalid_argument("blockSize must be positive");
+
+	const int nBlocks = (nTraj + blockSize - 1) / blockSize;
+	const long size   = static_cast<long>(neq) * blockSize;
+
+	auto work = [&](const int& b0, const int& b1) {
+		std::vector<double> buffer(6 * size);
+		double *y = buffer.data(), *Ystar = y + size;
+		double *k1 = Ystar + size, *k2 = k1 + size, *k3 = k2 + size, *k4 = k3 + size;
+
+		for (int b = b0; b < b1; b++) {
+			const int j0 = b * blockSize;
+			const int n  = std::min(blockSize, nTraj - j0);
+			const long m = static_cast<long>(neq) * n;
+
+			for (int i = 0; i < neq; i++)
+				std::copy(Y + static_cast<long>(i) * nTraj + j0, Y + static_cast<long>(i) * nTraj + j0 + n, y + i * n);
+
+			double tb = t;
+			for (int s = 0; s < nSteps; s++) {
+				RHSFunc(tb, y, k1, n);
+
+				for (long i = 0; i < m; i++) Ystar[i] = y[i] + 0.5 * dt * k1[i];
+				RHSFunc(tb + 0.5 * dt, Ystar, k2, n);
+
+				for (long i = 0; i < m; i++) Ystar[i] = y[i] + 0.5 * dt * k2[i];
+				RHSFunc(tb + 0.5 * dt, Ystar, k3, n);
+
+				for (long i = 0; i < m; i++) Ystar[i] = y[i] + dt * k3[i];
+				RHSFunc(tb + dt, Ystar, k4, n);
+
+				for (long i = 0; i < m; i++) y[i] += dt / 6.0 * (k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + k4[i]);
+				tb += dt;
+			}
+
+			for (int i = 0; i < neq; i++) std::copy(y + i * n, y + (i + 1) * n, Y + static_cast<long>(i) * nTraj + j0);
+		}
+	};
+	parallelFor(0, nBlocks, work, nThreads);
+}
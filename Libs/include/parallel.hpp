@@ -0,0 +1,133 @@
+/**
+ * @file parallel.hpp
+ *
+ * @brief      Implementation of the multithreading utility functions.
+ *
+ * @author     Francesco Marchisotti
+ *
+ * @date       17/10/2026
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief      Number of threads to use when the caller does not specify one.
+ *
+ * @return     The number of concurrent threads supported by the hardware (at
+ *             least 1).
+ */
+inline int defaultThreadCount() {
+	const int n = static_cast<int>(std::thread::hardware_concurrency());
+	return n > 0 ? n : 1;
+}
+
+/**
+ * @brief      Parallel for loop over the range [begin, end).
+ *
+ * Splits the range in (at most) `nThreads` contiguous chunks of equal size and
+ * calls `func(i0, i1)` on each chunk [i0, i1) from a different thread. The
+ * calling thread processes the first chunk. If any call throws, the first
+ * exception is rethrown after all threads have been joined.
+ *
+ * @param[in]  begin     First index of the range.
+ * @param[in]  end       One past the last index of the range.
+ * @param[in]  func      The function to call on every chunk.
+ * @param[in]  nThreads  The number of threads. If `nThreads <= 0`,
+ *                       defaultThreadCount() is used.
+ *
+ * @tparam     Func      Any callable with signature `void(int i0, int i1)`.
+ */
+template <class Func>
+void parallelFor(const int& begin, const int& end, Func&& func, int nThreads = 0) {
+	const int n = end - begin;
+	if (n <= 0) return;
+	if (nThreads <= 0) nThreads = defaultThreadCount();
+	if (nThreads > n) nThreads = n;
+	if (nThreads == 1) {
+		func(begin, end);
+		return;
+	}
+
+	std::vector<std::exception_ptr> errors(nThreads);
+	auto chunk = [&](const int& k) {
+		const int i0 = begin + static_cast<long long>(n) * k / nThreads;
+		const int i1 = begin + static_cast<long long>(n) * (k + 1) / nThreads;
+		try {
+			func(i0, i1);
+		} catch (...) {
+			errors[k] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(nThreads - 1);
+	for (int k = 1; k < nThreads; k++) threads.emplace_back(chunk, k);
+	chunk(0);
+	for (std::thread& t : threads) t.join();
+
+	for (std::exception_ptr& err : errors) {
+		if (err) std::rethrow_exception(err);
+	}
+}
+
+/**
+ * @brief      Parallel for loop over the range [begin, end) with dynamic
+ *             scheduling.
+ *
+ * The range is cut in chunks of `grain` indices that the threads take from a
+ * shared atomic counter as soon as they are idle, so iterations of very
+ * different cost are balanced among the threads. The calling thread takes part
+ * in the work; with a single thread `func` is called once on the whole range.
+ * If any call throws, no further chunks are handed out and the first exception
+ * is rethrown after all threads have been joined.
+ *
+ * @param[in]  begin     First index of the range.
+ * @param[in]  end       One past the last index of the range.
+ * @param[in]  func      The function to call on every chunk.
+ * @param[in]  nThreads  The number of threads. If `nThreads <= 0`,
+ *                       defaultThreadCount() is used.
+ * @param[in]  grain     The number of indices in a chunk.
+ *
+ * @tparam     Func      Any callable with signature `void(int i0, int i1)`.
+ */
+template <class Func>
+void parallelForDynamic(const int& begin, const int& end, Func&& func, int nThreads = 0, const int& grain = 1) {
+	const int n = end - begin;
+	if (n <= 0) return;
+	if (grain <= 0) throw std::invalid_argument("grain must be positive");
+	if (nThreads <= 0) nThreads = defaultThreadCount();
+	const int nChunks = (n - 1) / grain + 1;
+	if (nThreads > nChunks) nThreads = nChunks;
+	if (nThreads == 1) {
+		func(begin, end);
+		return;
+	}
+
+	std::atomic<long long> next(begin);
+	std::vector<std::exception_ptr> errors(nThreads);
+	auto worker = [&](const int& k) {
+		try {
+			for (long long i0 = next.fetch_add(grain); i0 < end; i0 = next.fetch_add(grain))
+				func(static_cast<int>(i0), static_cast<int>(std::min<long long>(i0 + grain, end)));
+		} catch (...) {
+			errors[k] = std::current_exception();
+			next      = end;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(nThreads - 1);
+	for (int k = 1; k < nThreads; k++) threads.emplace_back(worker, k);
+	worker(0);
+	for (std::thread& t : threads) t.join();
+
+	for (std::exception_ptr& err : errors) {
+		if (err) std::rethrow_exception(err);
+	}
+}
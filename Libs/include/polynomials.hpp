@@ -9,6 +9,7 @@
  */
 #pragma once
 
+#include <complex>
 #include <vector>
 
 /**
@@ -51,12 +52,13 @@ double hornerPol(const double& x, const double a[], const int& degree);
  *
  * @param[in]  x     The point at which to evaluate the polynomial.
  * @param[in]  a     Vector of the coefficients. **NOTE**: `a[0]` is the
- *                   constant term and `a[degree]` is the coefficient of x^n.
+ *                   constant term and `a.back()` is the coefficient of x^n
+ *                   (the degree is `a.size() - 1`).
  * @param[out] dpdx  The value of the derivative.
  *
- * @return     The value of the polynomial.
+ * @return     The value of the polynomial (0 if `a` is empty).
  */
-double hornerPol(const double& x, const std::vector<double> a, double& dpdx);
+double hornerPol(const double& x, const std::vector<double>& a, double& dpdx);
 
 /**
  * @overload
@@ -67,8 +69,200 @@ double hornerPol(const double& x, const std::vector<double> a, double& dpdx);
  *
  * @param[in]  x     The point at which to evaluate the polynomial.
  * @param[in]  a     Vector of the coefficients. **NOTE**: `a[0]` is the
- *                   constant term and `a[degree]` is the coefficient of x^n.
+ *                   constant term and `a.back()` is the coefficient of x^n
+ *                   (the degree is `a.size() - 1`).
+ *
+ * @return     The value of the polynomial (0 if `a` is empty).
+ */
+double hornerPol(const double& x, const std::vector<double>& a);
+
+/**
+ * @overload
+ *
+ * @brief      Horner method for polynomial evaluation at many points.
+ *
+ * The points are processed in blocks: every Horner step is applied to a whole
+ * block before moving to the next coefficient, so that the independent
+ * evaluations are interleaved (and vectorized) instead of waiting on each
+ * other's multiply-add chain.
+ *
+ * @param[in]  x       Array with the points at which to evaluate the
+ *                     polynomial.
+ * @param[out] p       Array with the values of the polynomial. Can be the same
+ *                     array as `x`.
+ * @param[in]  n       The number of points.
+ * @param[in]  a       Array of the coefficients. **NOTE**: `a[0]` is the
+ *                     constant term and `a[degree]` is the coefficient of x^n.
+ * @param[in]  degree  The degree of the polynomial.
+ */
+void hornerPol(const double x[], double p[], const int& n, const double a[], const int& degree);
+
+/**
+ * @overload
+ *
+ * @brief      Horner method for polynomial and derivative evaluation at many
+ *             points.
+ *
+ * @param[in]  x       Array with the points at which to evaluate the
+ *                     polynomial.
+ * @param[out] p       Array with the values of the polynomial.
+ * @param[out] dpdx    Array with the values of the derivative.
+ * @param[in]  n       The number of points.
+ * @param[in]  a       Array of the coefficients. **NOTE**: `a[0]` is the
+ *                     constant term and `a[degree]` is the coefficient of x^n.
+ * @param[in]  degree  The degree of the polynomial.
+ */
+void hornerPol(const double x[], double p[], double dpdx[], const int& n, const double a[], const int& degree);
+
+/**
+ * @brief      Estrin scheme for polynomial evaluation.
+ *
+ * Splits the polynomial as P(x) = L(x) + x^(2^k) H(x), where x^(2^k) is
+ * obtained by repeated squaring, and evaluates L and H in the same way. The
+ * two halves are independent, so the longest chain of dependent operations
+ * grows as log2(degree) instead of degree as in Horner method: this is faster
+ * for a single point of a high degree polynomial. The result can differ from
+ * Horner method by rounding.
+ *
+ * @param[in]  x       The point at which to evaluate the polynomial.
+ * @param[in]  a       Array of the coefficients. **NOTE**: `a[0]` is the
+ *                     constant term and `a[degree]` is the coefficient of x^n.
+ * @param[in]  degree  The degree of the polynomial.
+ *
+ * @return     The value of the polynomial.
+ */
+double estrinPol(const double& x, const double a[], const int& degree);
+
+/**
+ * @overload
+ *
+ * @brief      Estrin scheme for polynomial evaluation.
+ *
+ * @param[in]  x     The point at which to evaluate the polynomial.
+ * @param[in]  a     Vector of the coefficients, as in hornerPol().
+ *
+ * @return     The value of the polynomial (0 if `a` is empty).
+ */
+double estrinPol(const double& x, const std::vector<double>& a);
+
+/**
+ * @brief      Finds all the complex roots of a polynomial with the
+ *             Aberth-Ehrlich method.
+ *
+ * All the roots are refined simultaneously: every root takes a Newton step
+ * corrected by the repulsion from the other approximations, so there is no
+ * deflation of the polynomial and no loss of accuracy on the last roots.
+ * Exact zero roots (`a[0] = 0`, ...) are deflated beforehand. A root stops
+ * being updated when the value of the polynomial is within rounding of zero,
+ * so multiple roots are found to the accuracy the arithmetic allows
+ * (~eps^(1/m) for multiplicity m). The roots are not sorted.
+ *
+ * @param[in]  a        Array of the coefficients. **NOTE**: `a[0]` is the
+ *                      constant term and `a[degree]` is the coefficient of x^n.
+ * @param[in]  degree   The degree of the polynomial.
+ * @param[in]  maxIter  The maximum number of iterations.
+ *
+ * @return     Vector with the `degree` roots.
+ */
+std::vector<std::complex<double>> polRoots(const double a[], const int& degree, const int& maxIter = 256);
+
+/**
+ * @overload
+ *
+ * @param[in]  a        Vector of the coefficients, as in hornerPol().
+ * @param[in]  maxIter  The maximum number of iterations.
+ *
+ * @return     Vector with the `a.size() - 1` roots.
+ */
+std::vector<std::complex<double>> polRoots(const std::vector<double>& a, const int& maxIter = 256);
+
+/**
+ * @overload
+ *
+ * @brief      Finds all the complex roots of many polynomials of the same
+ *             degree.
+ *
+ * The polynomials are independent and are split among the threads.
+ *
+ * @param[in]  a         Array with the coefficients of the polynomials, one
+ *                       after the other: `a[k * (degree + 1) + i]` is the
+ *                       coefficient of x^i of the k-th polynomial.
+ * @param[in]  degree    The degree of the polynomials.
+ * @param[in]  nPol      The number of polynomials.
+ * @param[out] roots     Array with the roots: `roots[k * degree + i]` is the
+ *                       i-th root of the k-th polynomial.
+ * @param[in]  maxIter   The maximum number of iterations.
+ * @param[in]  nThreads  The number of threads. If `nThreads <= 0`,
+ *                       defaultThreadCount() is used.
+ */
+void polRoots(const double a[], const int& degree, const int& nPol, std::complex<double> roots[], const int& maxIter = 256, const int nThreads = 1);
+
+/**
+ * @brief      One step of the unrolled Horner method: applies the
+ *             coefficients from `a[I]` down to `a[0]` to the partial result
+ *             `p`.
+ *
+ * Used by the fixed degree hornerPol().
+ */
+template <int I>
+constexpr double hornerPolStep(const double& x, const double a[], const double& p) {
+	if constexpr (I < 0) return p;
+	else return hornerPolStep<I - 1>(x, a, p * x + a[I]);
+}
+
+/**
+ * @brief      Horner method for polynomial evaluation with the degree known at
+ *             compile time.
+ *
+ * The loop is unrolled at compile time into a chain of multiply-adds. Gives the
+ * same result as `hornerPol(x, a, Degree)` and can be used in constant
+ * expressions.
+ *
+ * @param[in]  x       The point at which to evaluate the polynomial.
+ * @param[in]  a       Array of the coefficients. **NOTE**: `a[0]` is the
+ *                     constant term and `a[Degree]` is the coefficient of x^n.
+ *
+ * @tparam     Degree  The degree of the polynomial.
+ *
+ * @return     The value of the polynomial.
+ */
+template <int Degree>
+constexpr double hornerPol(const double& x, const double a[]) {
+	static_assert(Degree >= 0, "Degree must be non negative");
+	return hornerPolStep<Degree - 1>(x, a, a[Degree]);
+}
+
+/**
+ * @brief      One step of the unrolled Horner method for the polynomial and its
+ *             derivative.
+ *
+ * Used by the fixed degree hornerPol().
+ */
+template <int I>
+constexpr double hornerPolStep(const double& x, const double a[], const double& p, const double& dp, double& dpdx) {
+	if constexpr (I < 0) {
+		dpdx = dp;
+		return p;
+	} else return hornerPolStep<I - 1>(x, a, p * x + a[I], dp * x + p, dpdx);
+}
+
+/**
+ * @overload
+ *
+ * @brief      Horner method for polynomial and derivative evaluation with the
+ *             degree known at compile time.
+ *
+ * @param[in]  x       The point at which to evaluate the polynomial.
+ * @param[in]  a       Array of the coefficients. **NOTE**: `a[0]` is the
+ *                     constant term and `a[Degree]` is the coefficient of x^n.
+ * @param[out] dpdx    The value of the derivative.
+ *
+ * @tparam     Degree  The degree of the polynomial.
  *
  * @return     The value of the polynomial.
  */
-double hornerPol(const double& x, const std::vector<double> a);
+template <int Degree>
+constexpr double hornerPol(const double& x, const double a[], double& dpdx) {
+	static_assert(Degree >= 0, "Degree must be non negative");
+	return hornerPolStep<Degree - 1>(x, a, a[Degree], 0.0, dpdx);
+}
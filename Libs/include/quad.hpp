@@ -8,68 +8,191 @@
 #pragma once
 
 #include <iostream>
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../include/parallel.hpp"
 
 /**
  * @brief      Rectangular quad method.
  *
  * Integrates a function using the rectangular quadrature method.
  *
- * @param[in]  F     The integrand function.
- * @param[in]  a,b   The lower and upper bound for the integral.
- * @param[in]  n     The number of sub-intervals to use for the integration.
+ * @param[in]  F         The integrand function.
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  n         The number of sub-intervals to use for the integration.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
+ *
+ * @return     The estimate of the integral.
+ */
+double rectangularQuad(double (*F)(const double& x), const double& a, const double& b, const int& n, const int nThreads = 1);
+
+/**
+ * @overload
+ *
+ * @brief      Rectangular quad method.
+ *
+ * Takes a batch integrand, which evaluates the function at many nodes in a
+ * single call, so that it can be vectorized.
+ *
+ * @param[in]  F         The batch integrand: `F(x, fx, n)` sets `fx[i]` to the
+ *                       value of the function at `x[i]`, for i in [0, n).
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  n         The number of sub-intervals to use for the integration.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
  *
  * @return     The estimate of the integral.
  */
-double rectangularQuad(double (*F)(const double& x), const double& a, const double& b, const int& n);
+double rectangularQuad(void (*F)(const double x[], double fx[], const int& n), const double& a, const double& b, const int& n, const int nThreads = 1);
 
 /**
  * @brief      Midpoint quad method.
  *
  * Integrates a function using the midpoint quadrature method.
  *
- * @param[in]  F     The integrand function.
- * @param[in]  a,b   The lower and upper bound for the integral.
- * @param[in]  n     The number of sub-intervals to use for the integration.
+ * @param[in]  F         The integrand function.
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  n         The number of sub-intervals to use for the integration.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
  *
  * @return     The estimate of the integral.
  */
-double midpointQuad(double (*F)(const double& x), const double& a, const double& b, const int& n);
+double midpointQuad(double (*F)(const double& x), const double& a, const double& b, const int& n, const int nThreads = 1);
+
+/**
+ * @overload
+ *
+ * @brief      Midpoint quad method.
+ *
+ * Takes a batch integrand, which evaluates the function at many nodes in a
+ * single call, so that it can be vectorized.
+ *
+ * @param[in]  F         The batch integrand: `F(x, fx, n)` sets `fx[i]` to the
+ *                       value of the function at `x[i]`, for i in [0, n).
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  n         The number of sub-intervals to use for the integration.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
+ *
+ * @return     The estimate of the integral.
+ */
+double midpointQuad(void (*F)(const double x[], double fx[], const int& n), const double& a, const double& b, const int& n, const int nThreads = 1);
 
 /**
  * @brief      Trapezoidal quad method.
  *
  * Integrates a function using the trapezoidal quadrature method.
  *
- * @param[in]  F     The integrand function.
- * @param[in]  a,b   The lower and upper bound for the integral.
- * @param[in]  n     The number of sub-intervals to use for the integration.
+ * @param[in]  F         The integrand function.
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  n         The number of sub-intervals to use for the integration.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
  *
  * @return     The estimate of the integral.
  */
-double trapezoidalQuad(double (*F)(const double& x), const double& a, const double& b, const int& n);
+double trapezoidalQuad(double (*F)(const double& x), const double& a, const double& b, const int& n, const int nThreads = 1);
+
+/**
+ * @overload
+ *
+ * @brief      Trapezoidal quad method.
+ *
+ * Takes a batch integrand, which evaluates the function at many nodes in a
+ * single call, so that it can be vectorized.
+ *
+ * @param[in]  F         The batch integrand: `F(x, fx, n)` sets `fx[i]` to the
+ *                       value of the function at `x[i]`, for i in [0, n).
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  n         The number of sub-intervals to use for the integration.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
+ *
+ * @return     The estimate of the integral.
+ */
+double trapezoidalQuad(void (*F)(const double x[], double fx[], const int& n), const double& a, const double& b, const int& n, const int nThreads = 1);
 
 /**
  * @brief      Simpson quad method.
  *
  * Integrates a function using the Simpson quadrature method.
  *
- * @param[in]  F     The integrand function.
- * @param[in]  a,b   The lower and upper bound for the integral.
- * @param[in]  n     The number of sub-intervals to use for the integration. Must
- *                   be even.
+ * @param[in]  F         The integrand function.
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  n         The number of sub-intervals to use for the integration.
+ *                       Must be even.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
  *
  * @return     The estimate of the integral.
  *
  * @throw      std::invalid_argument Thrown if N is even.
  */
-double simpsonQuad(double (*F)(const double& x), const double& a, const double& b, const int& n);
+double simpsonQuad(double (*F)(const double& x), const double& a, const double& b, const int& n, const int nThreads = 1);
+
+/**
+ * @overload
+ *
+ * @brief      Simpson quad method.
+ *
+ * Takes a batch integrand, which evaluates the function at many nodes in a
+ * single call, so that it can be vectorized.
+ *
+ * @param[in]  F         The batch integrand: `F(x, fx, n)` sets `fx[i]` to the
+ *                       value of the function at `x[i]`, for i in [0, n).
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  n         The number of sub-intervals to use for the integration.
+ *                       Must be even.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
+ *
+ * @return     The estimate of the integral.
+ *
+ * @throw      std::invalid_argument Thrown if N is odd.
+ */
+double simpsonQuad(void (*F)(const double x[], double fx[], const int& n), const double& a, const double& b, const int& n, const int nThreads = 1);
+
+/**
+ * @brief      Weights and roots of a Gauss-Legendre rule on [-1, 1].
+ *
+ * For odd Ng the first root is 0, then the roots come in (+x, -x) pairs by
+ * increasing |x|.
+ */
+struct GaussLegendreRule {
+	std::vector<double> weights;  //!< The legendre weights
+	std::vector<double> roots;    //!< The legendre roots
+};
+
+/**
+ * @brief      Gets the Gauss-Legendre rule with Ng points.
+ *
+ * The roots are found with Newton method on the Legendre recurrence the first
+ * time a given Ng is requested; the rule is then kept in a table shared by all
+ * the threads, so later calls only cost a lookup.
+ *
+ * @param[in]  Ng    Number of gaussian points.
+ *
+ * @return     The rule. The reference stays valid until the end of the
+ *             program.
+ */
+const GaussLegendreRule& gaussLegendreRule(const int& Ng);
 
 /**
  * @brief         Sets the legendre weights and roots.
  *
- * @param[in,out] weights  Array with the legendre weights.
- * @param[in,out] roots    Array with the legendre roots.
+ * Copies the rule returned by gaussLegendreRule().
+ *
+ * @param[in,out] weights  Array with the legendre weights. Must have room for
+ *                         Ng elements.
+ * @param[in,out] roots    Array with the legendre roots. Must have room for Ng
+ *                         elements.
  * @param[in]     Ng       Number of gaussian points.
  */
 void setLegendreWeightsAndRoots(double weights[], double roots[], const int& Ng);
@@ -80,14 +203,36 @@ void setLegendreWeightsAndRoots(double weights[], double roots[], const int& Ng)
  * Integrates a function using the Gauss-Legendre quadrature method.
  * This method is used with integrals between finite a and b.
  *
- * @param[in]  F     The integrand function.
- * @param[in]  a,b   The lower and upper bound for the integral.
- * @param[in]  N     The number of sub-intervals to use for the integration.
- * @param[in]  Ng    The number of gaussian points to use for each interval.
+ * @param[in]  F         The integrand function.
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  N         The number of sub-intervals to use for the integration.
+ * @param[in]  Ng        The number of gaussian points to use for each interval.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
+ *
+ * @return     The estimate of the integral.
+ */
+double gaussLegendreQuad(double (*F)(const double& x), const double& a, const double& b, const int N = 1, const int Ng = 3, const int nThreads = 1);
+
+/**
+ * @overload
+ *
+ * @brief      Gauss-Legendre quad method.
+ *
+ * Takes a batch integrand, which evaluates the function at many nodes in a
+ * single call, so that it can be vectorized.
+ *
+ * @param[in]  F         The batch integrand: `F(x, fx, n)` sets `fx[i]` to the
+ *                       value of the function at `x[i]`, for i in [0, n).
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  N         The number of sub-intervals to use for the integration.
+ * @param[in]  Ng        The number of gaussian points to use for each interval.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
  *
  * @return     The estimate of the integral.
  */
-double gaussLegendreQuad(double (*F)(const double& x), const double& a, const double& b, const int N = 1, const int Ng = 3);
+double gaussLegendreQuad(void (*F)(const double x[], double fx[], const int& n), const double& a, const double& b, const int N = 1, const int Ng = 3, const int nThreads = 1);
 
 /**
  * @brief      Gauss-Legendre quad method over a rectangle.
@@ -104,3 +249,452 @@ double gaussLegendreQuad(double (*F)(const double& x), const double& a, const do
  * @return     The estimate of the integral.
  */
 double gaussLegendreQuad2D(double (*F)(const double& x, const double& y), const double& xa, const double& xb, const double& ya, const double& yb, const int N = 1, const int Ng = 3);
+
+/**
+ * @brief      Gauss-Legendre quad method over a box in any dimension.
+ *
+ * Integrates a function over the box [xa[0], xb[0]] x ... x
+ * [xa[dim - 1], xb[dim - 1]] with the tensor product of composite
+ * Gauss-Legendre rules, each axis with its own number of sub-intervals and of
+ * gaussian points. The points are visited as an odometer, so that only the
+ * coordinates and partial weight products of the axes that change are
+ * updated. The number of points is the product over the axes of N[d] * Ng[d].
+ *
+ * @param[in]  F      The integrand function, `F(x)` with x the array of the
+ *                    dim coordinates.
+ * @param[in]  dim    The number of dimensions.
+ * @param[in]  xa,xb  Arrays with the lower and upper bounds along every axis.
+ * @param[in]  N      Array with the number of sub-intervals along every axis.
+ * @param[in]  Ng     Array with the number of gaussian points along every
+ *                    axis.
+ *
+ * @return     The estimate of the integral.
+ */
+double gaussLegendreQuadND(double (*F)(const double x[]), const int& dim, const double xa[], const double xb[], const int N[], const int Ng[]);
+
+/**
+ * @brief      Smolyak sparse grid quad method over a box in any dimension.
+ *
+ * Combines tensor products of Gauss-Legendre rules with few points (the
+ * combination technique): with the rule of `2 l[d] - 1` gaussian points along
+ * the axis d, the tensor products with l[0] + ... + l[dim - 1] between `level`
+ * and `level + dim - 1` are summed with alternating binomial coefficients. The
+ * weights of the points shared by more tensor products are merged, so every
+ * distinct point is evaluated once. The result is exact for polynomials of
+ * total degree up to 2 level - 1 (the level 1 rule is the midpoint rule, so
+ * e.g. x^2 y^2 is missed at level 2), with a number of points that grows
+ * polynomially with the dimension instead of as (2 level - 1)^dim. Suited to
+ * smooth integrands in 3 or more dimensions.
+ *
+ * @param[in]  F      The integrand function, `F(x)` with x the array of the
+ *                    dim coordinates.
+ * @param[in]  dim    The number of dimensions.
+ * @param[in]  xa,xb  Arrays with the lower and upper bounds along every axis.
+ * @param[in]  level  The level of the sparse grid. The largest number of
+ *                    gaussian points along one axis is 2 level - 1.
+ *
+ * @return     The estimate of the integral.
+ */
+double smolyakQuad(double (*F)(const double x[]), const int& dim, const double xa[], const double xb[], const int& level);
+
+/**
+ * @brief      Number of nodes that the quad methods evaluate at once.
+ */
+constexpr int quadBlockSize = 256;
+
+/**
+ * @brief      Evaluates the integrand at the n nodes x[].
+ *
+ * @tparam     Func  Either a scalar integrand, callable as `double(double x)`,
+ *                   or a batch integrand, callable as
+ *                   `void(const double x[], double fx[], const int& n)` like
+ *                   the rest of the library, or with `std::size_t n`.
+ */
+template <class Func>
+void quadEvaluate(const Func& F, const double x[], double fx[], const int& n) {
+	if constexpr (std::is_invocable_v<const Func&, const double*, double*, const int&>) {
+		F(x, fx, n);
+	} else if constexpr (std::is_invocable_v<const Func&, const double*, double*, std::size_t&>) {
+		std::size_t m = n;
+		F(x, fx, m);
+	} else {
+		static_assert(std::is_invocable_r_v<double, const Func&, const double&>, "The integrand must be callable as double(double) or void(const double*, double*, n)");
+		for (int i = 0; i < n; i++) fx[i] = F(x[i]);
+	}
+}
+
+/**
+ * @brief      Sum with Neumaier compensation of the rounding errors.
+ */
+struct NeumaierSum {
+	double sum  = 0.0;  //!< The running sum
+	double comp = 0.0;  //!< The accumulated rounding errors
+
+	/**
+	 * @brief      Adds a term to the sum.
+	 */
+	void add(const double& term) {
+		const double t = sum + term;
+		if (fabs(sum) >= fabs(term)) comp += (sum - t) + term;
+		else comp += (term - t) + sum;
+		sum = t;
+	}
+
+	/**
+	 * @brief      The compensated value of the sum.
+	 */
+	double value() const { return sum + comp; }
+};
+
+/**
+ * @brief      Weighted sum of the integrand over n nodes.
+ *
+ * The nodes are cut in chunks of quadBlockSize, a number that does not depend
+ * on the threads. Every chunk is generated by `nodes`, passed to the integrand
+ * at once and summed with Neumaier compensation; the chunks are split among
+ * the threads and their sums are combined by a pairwise reduction in a fixed
+ * order. Therefore the result is bit for bit the same for any number of
+ * threads. With `nThreads != 1` the integrand must be safe to call from many
+ * threads at once.
+ *
+ * @param[in]  F         The integrand, as in quadEvaluate().
+ * @param[in]  n         The number of nodes.
+ * @param[in]  nodes     Sets the m nodes from the i0-th one:
+ *                       `void(long long i0, int m, double x[], double w[])`.
+ * @param[in]  nThreads  The number of threads, as in parallelFor().
+ *
+ * @return     The sum of `w[i] * F(x[i])` for i in [0, n).
+ */
+template <class Func, class Nodes>
+double quadWeightedSum(const Func& F, const long long& n, const Nodes& nodes, const int& nThreads) {
+	auto chunkSum = [&](const long long& c) {
+		double x[quadBlockSize], fx[quadBlockSize], w[quadBlockSize];
+		const long long i0 = c * quadBlockSize;
+		const int m        = static_cast<int>(std::min<long long>(quadBlockSize, n - i0));
+		nodes(i0, m, x, w);
+		quadEvaluate(F, x, fx, m);
+		NeumaierSum sum;
+		for (int k = 0; k < m; k++) sum.add(w[k] * fx[k]);
+		return sum.value();
+	};
+
+	const int nChunks = static_cast<int>((n + quadBlockSize - 1) / quadBlockSize);
+	if (nChunks <= 0) return 0.0;
+	if (nChunks == 1) return chunkSum(0);
+
+	std::vector<double> partial(nChunks);
+	parallelFor(
+		0, nChunks,
+		[&](const int& c0, const int& c1) {
+			for (int c = c0; c < c1; c++) partial[c] = chunkSum(c);
+		},
+		nThreads);
+
+	// Pairwise reduction in a fixed order
+	for (int stride = 1; stride < nChunks; stride *= 2) {
+		for (int c = 0; c + stride < nChunks; c += 2 * stride) partial[c] += partial[c + stride];
+	}
+	return partial[0];
+}
+
+/**
+ * @overload
+ *
+ * @brief      Rectangular quad method for any callable integrand.
+ *
+ * @param[in]  F         The integrand, as in quadEvaluate(). The call is
+ *                       inlined.
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  n         The number of sub-intervals to use for the integration.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
+ *
+ * @return     The estimate of the integral.
+ */
+template <class Func>
+double rectangularQuad(const Func& F, const double& a, const double& b, const int& n, const int nThreads = 1) {
+	const double h = (b - a) / n;  // Interval width
+	auto nodes     = [&](const long long& i0, const int& m, double x[], double w[]) {
+		for (int k = 0; k < m; k++) {
+			x[k] = a + (i0 + k) * h;
+			w[k] = 1.0;
+		}
+	};
+	return h * quadWeightedSum(F, n, nodes, nThreads);
+}
+
+/**
+ * @overload
+ *
+ * @brief      Trapezoidal quad method for any callable integrand.
+ *
+ * @param[in]  F         The integrand, as in quadEvaluate(). The call is
+ *                       inlined.
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  n         The number of sub-intervals to use for the integration.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
+ *
+ * @return     The estimate of the integral.
+ */
+template <class Func>
+double trapezoidalQuad(const Func& F, const double& a, const double& b, const int& n, const int nThreads = 1) {
+	const double h = (b - a) / n;  // Interval width
+	auto nodes     = [&](const long long& i0, const int& m, double x[], double w[]) {
+		for (int k = 0; k < m; k++) {
+			const long long i = i0 + k;
+			x[k]              = a + i * h;
+			w[k]              = i == 0 || i == n ? 0.5 : 1.0;
+		}
+	};
+	return h * quadWeightedSum(F, n + 1, nodes, nThreads);
+}
+
+/**
+ * @overload
+ *
+ * @brief      Simpson quad method for any callable integrand.
+ *
+ * @param[in]  F         The integrand, as in quadEvaluate(). The call is
+ *                       inlined.
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  n         The number of sub-intervals to use for the integration.
+ *                       Must be even.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
+ *
+ * @return     The estimate of the integral.
+ *
+ * @throw      std::invalid_argument Thrown if N is odd.
+ */
+template <class Func>
+double simpsonQuad(const Func& F, const double& a, const double& b, const int& n, const int nThreads = 1) {
+	if (n % 2 != 0) throw std::invalid_argument("simpsonQuad(): Invalid argument: n must be even.");
+
+	const double h = (b - a) / n;  // Interval width
+	auto nodes     = [&](const long long& i0, const int& m, double x[], double w[]) {
+		for (int k = 0; k < m; k++) {
+			const long long i = i0 + k;
+			x[k]              = a + i * h;
+			w[k]              = i == 0 || i == n ? 1.0 : (i % 2 != 0 ? 4.0 : 2.0);
+		}
+	};
+	return h / 3 * quadWeightedSum(F, n + 1, nodes, nThreads);
+}
+
+/**
+ * @overload
+ *
+ * @brief      Gauss-Legendre quad method for any callable integrand.
+ *
+ * The nodes of all the sub-intervals are generated in blocks of quadBlockSize
+ * and each block is passed to the integrand at once.
+ *
+ * @param[in]  F         The integrand, as in quadEvaluate(). The call is
+ *                       inlined.
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  N         The number of sub-intervals to use for the integration.
+ * @param[in]  Ng        The number of gaussian points to use for each interval.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
+ *
+ * @return     The estimate of the integral.
+ */
+template <class Func>
+double gaussLegendreQuad(const Func& F, const double& a, const double& b, const int N = 1, const int Ng = 3, const int nThreads = 1) {
+	const GaussLegendreRule& rule = gaussLegendreRule(Ng);
+	const double h                = (b - a) / N;  // Interval width
+	auto nodes                    = [&](const long long& i0, const int& m, double x[], double w[]) {
+		long long i = i0 / Ng;  // Interval of the first node
+		int j       = i0 % Ng;  // Gaussian point of the first node
+		for (int k = 0; k < m; k++) {
+			x[k] = a + (i + 0.5) * h + 0.5 * h * rule.roots[j];
+			w[k] = rule.weights[j];
+			if (++j == Ng) {
+				j = 0;
+				i++;
+			}
+		}
+	};
+
+	return 0.5 * h * quadWeightedSum(F, static_cast<long long>(N) * Ng, nodes, nThreads);  // Finalize calculation and return
+}
+
+/**
+ * @overload
+ *
+ * @brief      Midpoint quad method for any callable integrand.
+ *
+ * @param[in]  F         The integrand, as in quadEvaluate(). The call is
+ *                       inlined.
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  n         The number of sub-intervals to use for the integration.
+ * @param[in]  nThreads  The number of threads, as in parallelFor(). The result
+ *                       does not depend on it.
+ *
+ * @return     The estimate of the integral.
+ */
+template <class Func>
+double midpointQuad(const Func& F, const double& a, const double& b, const int& n, const int nThreads = 1) {
+	// Gauss-Legendre rule converges to midpoint rule for Ng = 1
+	return gaussLegendreQuad(F, a, b, n, 1, nThreads);
+}
+
+/**
+ * @brief      Romberg quad method.
+ *
+ * Halves the step of the trapezoidal rule at every level, evaluating the
+ * integrand only at the new midpoints, and applies Richardson extrapolation
+ * to the sequence of estimates. Stops when two consecutive diagonal entries of
+ * the table differ by less than `tol` (from the second level on) or after
+ * `maxLevel` halvings; in the last case `err` can be larger than `tol`.
+ *
+ * @param[in]  F         The integrand function.
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  tol       The absolute tolerance on the integral.
+ * @param[out] err       The error estimate, the difference between the last
+ *                       two diagonal entries.
+ * @param[in]  maxLevel  The maximum number of halvings of the step.
+ *
+ * @return     The estimate of the integral.
+ */
+double rombergQuad(double (*F)(const double& x), const double& a, const double& b, const double& tol, double& err, const int& maxLevel = 20);
+
+/**
+ * @overload
+ *
+ * @brief      Romberg quad method.
+ *
+ * @param[in]  F     The integrand function.
+ * @param[in]  a,b   The lower and upper bound for the integral.
+ * @param[in]  tol   The absolute tolerance on the integral.
+ *
+ * @return     The estimate of the integral.
+ */
+double rombergQuad(double (*F)(const double& x), const double& a, const double& b, const double& tol = 1e-10);
+
+/**
+ * @brief      Adaptive Gauss-Kronrod quad method.
+ *
+ * Integrates a function with a Gauss-Kronrod pair on every sub-interval (G7K15
+ * or G10K21): the Kronrod rule reuses the function values at the Gauss nodes,
+ * and the difference between the two estimates is the error estimate of the
+ * sub-interval. The sub-intervals are kept in a priority queue and the one
+ * with the largest error is bisected, so the evaluations concentrate where the
+ * integrand is rough. Stops when the total error estimate is below `tol`, when
+ * `maxIntervals` sub-intervals are reached or when the worst sub-interval can
+ * no longer be split; in the last two cases `err` can be larger than `tol`.
+ *
+ * @param[in]  F             The integrand function.
+ * @param[in]  a,b           The lower and upper bound for the integral.
+ * @param[in]  tol           The absolute tolerance on the integral.
+ * @param[out] err           The error estimate.
+ * @param[in]  points        The number of Kronrod points, 15 (G7K15) or 21
+ *                           (G10K21).
+ * @param[in]  maxIntervals  The maximum number of sub-intervals.
+ *
+ * @return     The estimate of the integral.
+ */
+double gaussKronrodQuad(double (*F)(const double& x), const double& a, const double& b, const double& tol, double& err, const int& points = 15, const int& maxIntervals = 1000);
+
+/**
+ * @overload
+ *
+ * @brief      Adaptive Gauss-Kronrod quad method.
+ *
+ * @param[in]  F     The integrand function.
+ * @param[in]  a,b   The lower and upper bound for the integral.
+ * @param[in]  tol   The absolute tolerance on the integral.
+ *
+ * @return     The estimate of the integral.
+ */
+double gaussKronrodQuad(double (*F)(const double& x), const double& a, const double& b, const double& tol = 1e-10);
+
+/**
+ * @brief      Tanh-sinh (double exponential) quad method.
+ *
+ * Maps [a, b] to the real line with x = tanh(pi/2 sinh(t)) and applies the
+ * trapezoidal rule in t. The weights decay double exponentially, so the rule
+ * converges exponentially even for integrands with (integrable) singularities
+ * at the endpoints, which are never evaluated. The step in t is halved at every
+ * level and only the new nodes are evaluated; the nodes and weights of every
+ * level are computed once and kept in a table shared by all the threads.
+ *
+ * @param[in]  F         The integrand function.
+ * @param[in]  a,b       The lower and upper bound for the integral.
+ * @param[in]  tol       The absolute tolerance on the integral.
+ * @param[out] err       The error estimate, the difference between the last
+ *                       two levels.
+ * @param[in]  maxLevel  The maximum number of halvings of the step.
+ *
+ * @return     The estimate of the integral.
+ */
+double tanhSinhQuad(double (*F)(const double& x), const double& a, const double& b, const double& tol, double& err, const int& maxLevel = 10);
+
+/**
+ * @overload
+ *
+ * @brief      Tanh-sinh (double exponential) quad method.
+ *
+ * @param[in]  F     The integrand function.
+ * @param[in]  a,b   The lower and upper bound for the integral.
+ * @param[in]  tol   The absolute tolerance on the integral.
+ *
+ * @return     The estimate of the integral.
+ */
+double tanhSinhQuad(double (*F)(const double& x), const double& a, const double& b, const double& tol = 1e-10);
+
+/**
+ * @brief      Exp-sinh (double exponential) quad method over [a, +inf).
+ *
+ * As tanhSinhQuad(), with the map x = a + exp(pi/2 sinh(t)). Suited to
+ * integrands that decay at infinity and can be singular at a.
+ *
+ * @param[in]  F         The integrand function.
+ * @param[in]  a         The lower bound for the integral.
+ * @param[in]  tol       The absolute tolerance on the integral.
+ * @param[out] err       The error estimate.
+ * @param[in]  maxLevel  The maximum number of halvings of the step.
+ *
+ * @return     The estimate of the integral.
+ */
+double expSinhQuad(double (*F)(const double& x), const double& a, const double& tol, double& err, const int& maxLevel = 10);
+
+/**
+ * @overload
+ *
+ * @brief      Exp-sinh (double exponential) quad method over [a, +inf).
+ *
+ * @param[in]  F     The integrand function.
+ * @param[in]  a     The lower bound for the integral.
+ * @param[in]  tol   The absolute tolerance on the integral.
+ *
+ * @return     The estimate of the integral.
+ */
+double expSinhQuad(double (*F)(const double& x), const double& a, const double& tol = 1e-10);
+
+/**
+ * @brief      Sinh-sinh (double exponential) quad method over (-inf, +inf).
+ *
+ * As tanhSinhQuad(), with the map x = sinh(pi/2 sinh(t)).
+ *
+ * @param[in]  F         The integrand function.
+ * @param[in]  tol       The absolute tolerance on the integral.
+ * @param[out] err       The error estimate.
+ * @param[in]  maxLevel  The maximum number of halvings of the step.
+ *
+ * @return     The estimate of the integral.
+ */
+double sinhSinhQuad(double (*F)(const double& x), const double& tol, double& err, const int& maxLevel = 10);
+
+/**
+ * @overload
+ *
+ * @brief      Sinh-sinh (double exponential) quad method over (-inf, +inf).
+ *
+ * @param[in]  F     The integrand function.
+ * @param[in]  tol   The absolute tolerance on the integral.
+ *
+ * @return     The estimate of the integral.
+ */
+double sinhSinhQuad(double (*F)(const double& x), const double& tol = 1e-10);
@@ -11,6 +11,10 @@
 
 #include <iostream>
 #include <iomanip>
+#include <string>
+#include <vector>
+
+#include "../include/root_method.hpp"
 
 /**
  * @overload
@@ -27,11 +31,16 @@
  * @param[in]  xa      Lower bound of the interval.
  * @param[in]  xb      Upper bound of the interval.
  * @param[in]  tol     x-tolerance.
- * @param[out] roots   Array with the roots of f(x, k).
+ * @param[out] roots   Array with the roots of f(x, k) (room for `N` values).
  * @param[out] nRoots  The number of roots found.
  * @param[in]  N       The number of sub-intervals.
  * @param[in]  method  The root finding method. Accepted values are:
- *                     `bisection`, `falsePosition`, `secant`, `newton`.
+ *                     `bisection`, `falsePosition`, `secant`, `newton`,
+ *                     `brent`, `illinois`.
+ * @param[in]  nThreads  The number of threads used to evaluate the grid and
+ *                     to refine the brackets (1: sequential; `<= 0`: all the
+ *                     cores). `f` must be safe to call concurrently when it
+ *                     is not 1.
  *
  * @return     flag
  *
@@ -39,7 +48,7 @@
  * @retval     1       Too many steps.
  * @retval     2       Initial interval doesn't contain any root.
  *
- * @throws     std::invalid_argument  Thrown if `N` > 128.
+ * @throws     std::invalid_argument  Thrown if `N` is not positive.
  * @throws     std::invalid_argument  Thrown if `method` is not among the
  *                                    accepted values.
  * @throws     std::runtime_error     Thrown if roots can't be found inside the
@@ -47,7 +56,7 @@
  * @throws     std::runtime_error     Thrown if one of the root finders exceeded
  *                                    the maximum number of steps.
  */
-int findRoots(double (*f)(const double& x, const double& param), double (*dfdx)(const double& x, const double& param), const double& param, const double& xa, const double& xb, const double& tol, double roots[], int& nRoots, const int N = 128, const std::string method = "newton");
+int findRoots(double (*f)(const double& x, const double& param), double (*dfdx)(const double& x, const double& param), const double& param, const double& xa, const double& xb, const double& tol, double roots[], int& nRoots, const int N = 128, const std::string method = "newton", const int nThreads = 1);
 
 /**
  * @overload
@@ -64,11 +73,16 @@ int findRoots(double (*f)(const double& x, const double& param), double (*dfdx)(
  * @param[in]  xa      Lower bound of the interval.
  * @param[in]  xb      Upper bound of the interval.
  * @param[in]  tol     x-tolerance.
- * @param[out] roots   Array with the roots of f(x, k).
+ * @param[out] roots   Array with the roots of f(x, k) (room for `N` values).
  * @param[out] nRoots  The number of roots found.
  * @param[in]  N       The number of sub-intervals.
  * @param[in]  method  The root finding method. Accepted values are:
- *                     `bisection`, `falsePosition`, `secant`.
+ *                     `bisection`, `falsePosition`, `secant`, `brent`,
+ *                     `illinois`.
+ * @param[in]  nThreads  The number of threads used to evaluate the grid and
+ *                     to refine the brackets (1: sequential; `<= 0`: all the
+ *                     cores). `f` must be safe to call concurrently when it
+ *                     is not 1.
  *
  * @return     flag
  *
@@ -76,7 +90,7 @@ int findRoots(double (*f)(const double& x, const double& param), double (*dfdx)(
  * @retval     1       Too many steps.
  * @retval     2       Initial interval doesn't contain any root.
  *
- * @throws     std::invalid_argument  Thrown if `N` > 128.
+ * @throws     std::invalid_argument  Thrown if `N` is not positive.
  * @throws     std::invalid_argument  Thrown if `method` is not among the accepted
  *                                    values.
  * @throws     std::runtime_error     Thrown if roots can't be found inside the
@@ -84,7 +98,97 @@ int findRoots(double (*f)(const double& x, const double& param), double (*dfdx)(
  * @throws     std::runtime_error     Thrown if one of the root finders exceeded
  *                                    the maximum number of steps.
  */
-int findRoots(double (*f)(const double& x, const double& param), const double& param, const double& xa, const double& xb, const double& tol, double roots[], int& nRoots, const int N = 128, const std::string method = "bisection");
+int findRoots(double (*f)(const double& x, const double& param), const double& param, const double& xa, const double& xb, const double& tol, double roots[], int& nRoots, const int N = 128, const std::string method = "bisection", const int nThreads = 1);
+
+/**
+ * @overload
+ *
+ * @brief      Find the roots of a function in a given interval, with the
+ *             method already resolved.
+ *
+ * The brackets are refined concurrently with dynamic scheduling, since their
+ * cost can be very different.
+ *
+ * @param[in]  f         Pointer to the function.
+ * @param[in]  dfdx      Pointer to the derivative of the function (only used,
+ *                       and required, by RootMethod::newton).
+ * @param[in]  param     Additional function parameter.
+ * @param[in]  xa        Lower bound of the interval.
+ * @param[in]  xb        Upper bound of the interval.
+ * @param[in]  tol       x-tolerance.
+ * @param[out] roots     Array with the roots of f(x) (room for `N` values).
+ * @param[out] nRoots    The number of roots found.
+ * @param[in]  N         The number of sub-intervals.
+ * @param[in]  method    The root finding method.
+ * @param[in]  nThreads  The number of threads (1: sequential; `<= 0`: all the
+ *                       cores). `f` must be safe to call concurrently when it
+ *                       is not 1.
+ *
+ * @return     flag
+ *
+ * @retval     0         Success.
+ *
+ * @throws     std::invalid_argument  Thrown if `N` is not positive.
+ * @throws     std::invalid_argument  Thrown if `method` is RootMethod::newton
+ *                                    and `dfdx` is null.
+ * @throws     std::runtime_error     Thrown if roots can't be found inside the
+ *                                    interval.
+ * @throws     std::runtime_error     Thrown if one of the root finders exceeded
+ *                                    the maximum number of steps.
+ */
+int findRoots(double (*f)(const double& x, const double& param), double (*dfdx)(const double& x, const double& param), const double& param, const double& xa, const double& xb, const double& tol, double roots[], int& nRoots, const int N, const RootMethod method, const int nThreads = 1);
+
+/**
+ * @overload
+ *
+ * @brief      Find the roots of a function in a given interval, with the
+ *             method already resolved (Newton's method not available).
+ */
+int findRoots(double (*f)(const double& x, const double& param), const double& param, const double& xa, const double& xb, const double& tol, double roots[], int& nRoots, const int N, const RootMethod method, const int nThreads = 1);
+
+/**
+ * @overload
+ *
+ * @brief      Find all the roots of a function in a given interval.
+ *
+ * Same as the array versions, but with no limit on the number of roots. The
+ * brackets are found by bracketAdaptive(), so with `maxDepth > 0` pairs of
+ * close roots that fall in the same sub-interval of the uniform scan can be
+ * found too.
+ *
+ * @param[in]  f         Pointer to the function.
+ * @param[in]  dfdx      Pointer to the derivative of the function (only used,
+ *                       and required, by RootMethod::newton).
+ * @param[in]  param     Additional function parameter.
+ * @param[in]  xa        Lower bound of the interval.
+ * @param[in]  xb        Upper bound of the interval.
+ * @param[in]  tol       x-tolerance.
+ * @param[in]  N         The number of sub-intervals of the uniform scan.
+ * @param[in]  method    The root finding method.
+ * @param[in]  maxDepth  Maximum number of halvings, hence of extra
+ *                       evaluations of f, of each suspicious sub-interval
+ *                       (0: uniform scan only).
+ * @param[in]  nThreads  The number of threads (1: sequential; `<= 0`: all the
+ *                       cores). `f` must be safe to call concurrently when it
+ *                       is not 1.
+ *
+ * @return     The roots of f(x), in increasing order (empty if there are none).
+ *
+ * @throws     std::invalid_argument  Thrown if `N` is not positive.
+ * @throws     std::invalid_argument  Thrown if `method` is RootMethod::newton
+ *                                    and `dfdx` is null.
+ * @throws     std::runtime_error     Thrown if one of the root finders exceeded
+ *                                    the maximum number of steps.
+ */
+std::vector<double> findRoots(double (*f)(const double& x, const double& param), double (*dfdx)(const double& x, const double& param), const double& param, const double& xa, const double& xb, const double& tol, const int N, const RootMethod method, const int maxDepth = 0, const int nThreads = 1);
+
+/**
+ * @overload
+ *
+ * @brief      Find all the roots of a function in a given interval (Newton's
+ *             method not available).
+ */
+std::vector<double> findRoots(double (*f)(const double& x, const double& param), const double& param, const double& xa, const double& xb, const double& tol, const int N = 128, const RootMethod method = RootMethod::brent, const int maxDepth = 0, const int nThreads = 1);
 
 /**
  * @brief      Bracket the roots of a function in a given interval [xa, xb].
@@ -102,10 +206,45 @@ int findRoots(double (*f)(const double& x, const double& param), const double& p
  *                     a root.
  * @param[out] xR      Array with the upper bound of the sub-interval containing
  *                     a root.
- * @param[in]  N       The number of sub-intervals.
- * @param[out] nRoots  The number of roots found.
+ * @param[in]  N         The number of sub-intervals.
+ * @param[out] nRoots    The number of roots found.
+ * @param[in]  nThreads  The number of threads used to evaluate the N + 1 grid
+ *                       points (1: sequential; `<= 0`: all the cores).
+ */
+void bracket(double (*f)(const double& x, const double& param), const double& param, const double& xa, const double& xb, double xL[], double xR[], const int& N, int& nRoots, const int nThreads = 1);
+
+/**
+ * @brief      Bracket the roots of a function in a given interval [xa, xb],
+ *             refining the scan where needed.
+ *
+ * Starts from the uniform scan of bracket(). A sub-interval where f(x) does
+ * not change sign may still hide a pair of roots, or a root next to a pole,
+ * when it ends at a local minimum of |f| on the grid, or when f changes
+ * rapidly there: its first difference, or the second difference at one of
+ * its ends, is more than four times the mean over the grid. Such a
+ * sub-interval is halved up to `maxDepth` times, keeping one half each time:
+ * the half towards the smaller end if |f| at the midpoint is below |f| at
+ * both ends, otherwise the half where f changes more, if it changes by more
+ * than 3/4 of its change over the current sub-interval. The halving stops
+ * when neither holds. A sign change at a midpoint gives two brackets. The
+ * refinement thus costs at most `maxDepth` evaluations of f per suspicious
+ * sub-interval.
+ *
+ * @param[in]  f         Pointer to the function.
+ * @param[in]  param     Additional function parameter.
+ * @param[in]  xa        Lower bound of the interval.
+ * @param[in]  xb        Upper bound of the interval.
+ * @param[out] xL        The lower bounds of the brackets, in increasing order.
+ * @param[out] xR        The upper bounds of the brackets.
+ * @param[in]  N         The number of sub-intervals of the uniform scan.
+ * @param[in]  maxDepth  Maximum number of halvings of each suspicious
+ *                       sub-interval (0: uniform scan only).
+ * @param[in]  nThreads  The number of threads (1: sequential; `<= 0`: all the
+ *                       cores).
+ *
+ * @throws     std::invalid_argument  Thrown if `N` is not positive.
  */
-void bracket(double (*f)(const double& x, const double& param), const double& param, const double& xa, const double& xb, double xL[], double xR[], const int& N, int& nRoots);
+void bracketAdaptive(double (*f)(const double& x, const double& param), const double& param, const double& xa, const double& xb, std::vector<double>& xL, std::vector<double>& xR, const int& N, const int& maxDepth, const int nThreads = 1);
 
 /**
  * @overload
@@ -323,6 +462,232 @@ int falsePosition(double (*f)(const double& x, const double& param), const doubl
  */
 int falsePosition(double (*f)(const double& x, const double& param), const double& param, double xa, double xb, const double& xtol, const double& ftol, double& root);
 
+
+/**
+ * @overload
+ *
+ * @brief      Find the root of a function f(x, k) in a given interval [xa, xb]
+ *             using Brent's method. k is simply passed to the function.
+ *
+ * Combines inverse quadratic interpolation, secant steps and bisection: the
+ * root stays bracketed and the convergence is superlinear. Every iteration
+ * costs one evaluation of f.
+ *
+ * @param[in]  f     Pointer to the function.
+ * @param[in]  param Additional function parameter.
+ * @param[in]  xa    Lower bound of the interval.
+ * @param[in]  xb    Upper bound of the interval.
+ * @param[in]  xtol  x-tolerance.
+ * @param[in]  ftol  f(x, k)-tolerance: the values of f(x, k) that are considered 0.
+ * @param[out] root  The root of f(x, k).
+ * @param[out] ntry  The number of iterations achieved.
+ *
+ * @return     flag
+ *
+ * @retval     0     Success.
+ * @retval     1     Too many steps.
+ * @retval     2     Initial interval doesn't contain any root.
+ *
+ * @throws     std::runtime_error  Thrown if roots can't be found inside the
+ *                                 interval.
+ * @throws     std::runtime_error  Thrown if the maximum number of steps is
+ *                                 exceeded.
+ */
+int brent(double (*f)(const double& x, const double& param), const double& param, double xa, double xb, const double& xtol, const double& ftol, double& root, int& ntry);
+
+/**
+ * @overload
+ *
+ * @brief      Find the root of a function f(x, k) in a given interval [xa, xb]
+ *             using Brent's method. k is simply passed to the function.
+ *
+ * @param[in]  f     Pointer to the function.
+ * @param[in]  param Additional function parameter.
+ * @param[in]  xa    Lower bound of the interval.
+ * @param[in]  xb    Upper bound of the interval.
+ * @param[in]  xtol  x-tolerance.
+ * @param[out] root  The root of f(x, k).
+ *
+ * @return     flag
+ *
+ * @retval     0     Success.
+ * @retval     1     Too many steps.
+ * @retval     2     Initial interval doesn't contain any root.
+ *
+ * @throws     std::runtime_error  Thrown if roots can't be found inside the
+ *                                 interval.
+ * @throws     std::runtime_error  Thrown if the maximum number of steps is
+ *                                 exceeded.
+ */
+int brent(double (*f)(const double& x, const double& param), const double& param, double xa, double xb, const double& xtol, double& root);
+
+/**
+ * @overload
+ *
+ * @brief      Find the root of a function f(x, k) in a given interval [xa, xb]
+ *             using Brent's method. k is simply passed to the function.
+ *
+ * @param[in]  f     Pointer to the function.
+ * @param[in]  param Additional function parameter.
+ * @param[in]  xa    Lower bound of the interval.
+ * @param[in]  xb    Upper bound of the interval.
+ * @param[in]  xtol  x-tolerance.
+ * @param[out] root  The root of f(x, k).
+ * @param[out] ntry  The number of iterations achieved.
+ *
+ * @return     flag
+ *
+ * @retval     0     Success.
+ * @retval     1     Too many steps.
+ * @retval     2     Initial interval doesn't contain any root.
+ *
+ * @throws     std::runtime_error  Thrown if roots can't be found inside the
+ *                                 interval.
+ * @throws     std::runtime_error  Thrown if the maximum number of steps is
+ *                                 exceeded.
+ */
+int brent(double (*f)(const double& x, const double& param), const double& param, double xa, double xb, const double& xtol, double& root, int& ntry);
+
+/**
+ * @overload
+ *
+ * @brief      Find the root of a function f(x, k) in a given interval [xa, xb]
+ *             using Brent's method. k is simply passed to the function.
+ *
+ * @param[in]  f     Pointer to the function.
+ * @param[in]  param Additional function parameter.
+ * @param[in]  xa    Lower bound of the interval.
+ * @param[in]  xb    Upper bound of the interval.
+ * @param[in]  xtol  x-tolerance.
+ * @param[in]  ftol  f(x, k)-tolerance: the values of f(x, k) that are considered 0.
+ * @param[out] root  The root of f(x, k).
+ *
+ * @return     flag
+ *
+ * @retval     0     Success.
+ * @retval     1     Too many steps.
+ * @retval     2     Initial interval doesn't contain any root.
+ *
+ * @throws     std::runtime_error  Thrown if roots can't be found inside the
+ *                                 interval.
+ * @throws     std::runtime_error  Thrown if the maximum number of steps is
+ *                                 exceeded.
+ */
+int brent(double (*f)(const double& x, const double& param), const double& param, double xa, double xb, const double& xtol, const double& ftol, double& root);
+
+
+/**
+ * @overload
+ *
+ * @brief      Find the root of a function f(x, k) in a given interval [xa, xb]
+ *             using the Illinois method. k is simply passed to the function.
+ *
+ * Modified false position: when the same end of the interval is kept twice
+ * in a row, its function value is halved, so that both ends converge to the
+ * root superlinearly. Every iteration costs one evaluation of f.
+ *
+ * @param[in]  f     Pointer to the function.
+ * @param[in]  param Additional function parameter.
+ * @param[in]  xa    Lower bound of the interval.
+ * @param[in]  xb    Upper bound of the interval.
+ * @param[in]  xtol  x-tolerance.
+ * @param[in]  ftol  f(x, k)-tolerance: the values of f(x, k) that are considered 0.
+ * @param[out] root  The root of f(x, k).
+ * @param[out] ntry  The number of iterations achieved.
+ *
+ * @return     flag
+ *
+ * @retval     0     Success.
+ * @retval     1     Too many steps.
+ * @retval     2     Initial interval doesn't contain any root.
+ *
+ * @throws     std::runtime_error  Thrown if roots can't be found inside the
+ *                                 interval.
+ * @throws     std::runtime_error  Thrown if the maximum number of steps is
+ *                                 exceeded.
+ */
+int illinois(double (*f)(const double& x, const double& param), const double& param, double xa, double xb, const double& xtol, const double& ftol, double& root, int& ntry);
+
+/**
+ * @overload
+ *
+ * @brief      Find the root of a function f(x, k) in a given interval [xa, xb]
+ *             using the Illinois method. k is simply passed to the function.
+ *
+ * @param[in]  f     Pointer to the function.
+ * @param[in]  param Additional function parameter.
+ * @param[in]  xa    Lower bound of the interval.
+ * @param[in]  xb    Upper bound of the interval.
+ * @param[in]  xtol  x-tolerance.
+ * @param[out] root  The root of f(x, k).
+ *
+ * @return     flag
+ *
+ * @retval     0     Success.
+ * @retval     1     Too many steps.
+ * @retval     2     Initial interval doesn't contain any root.
+ *
+ * @throws     std::runtime_error  Thrown if roots can't be found inside the
+ *                                 interval.
+ * @throws     std::runtime_error  Thrown if the maximum number of steps is
+ *                                 exceeded.
+ */
+int illinois(double (*f)(const double& x, const double& param), const double& param, double xa, double xb, const double& xtol, double& root);
+
+/**
+ * @overload
+ *
+ * @brief      Find the root of a function f(x, k) in a given interval [xa, xb]
+ *             using the Illinois method. k is simply passed to the function.
+ *
+ * @param[in]  f     Pointer to the function.
+ * @param[in]  param Additional function parameter.
+ * @param[in]  xa    Lower bound of the interval.
+ * @param[in]  xb    Upper bound of the interval.
+ * @param[in]  xtol  x-tolerance.
+ * @param[out] root  The root of f(x, k).
+ * @param[out] ntry  The number of iterations achieved.
+ *
+ * @return     flag
+ *
+ * @retval     0     Success.
+ * @retval     1     Too many steps.
+ * @retval     2     Initial interval doesn't contain any root.
+ *
+ * @throws     std::runtime_error  Thrown if roots can't be found inside the
+ *                                 interval.
+ * @throws     std::runtime_error  Thrown if the maximum number of steps is
+ *                                 exceeded.
+ */
+int illinois(double (*f)(const double& x, const double& param), const double& param, double xa, double xb, const double& xtol, double& root, int& ntry);
+
+/**
+ * @overload
+ *
+ * @brief      Find the root of a function f(x, k) in a given interval [xa, xb]
+ *             using the Illinois method. k is simply passed to the function.
+ *
+ * @param[in]  f     Pointer to the function.
+ * @param[in]  param Additional function parameter.
+ * @param[in]  xa    Lower bound of the interval.
+ * @param[in]  xb    Upper bound of the interval.
+ * @param[in]  xtol  x-tolerance.
+ * @param[in]  ftol  f(x, k)-tolerance: the values of f(x, k) that are considered 0.
+ * @param[out] root  The root of f(x, k).
+ *
+ * @return     flag
+ *
+ * @retval     0     Success.
+ * @retval     1     Too many steps.
+ * @retval     2     Initial interval doesn't contain any root.
+ *
+ * @throws     std::runtime_error  Thrown if roots can't be found inside the
+ *                                 interval.
+ * @throws     std::runtime_error  Thrown if the maximum number of steps is
+ *                                 exceeded.
+ */
+int illinois(double (*f)(const double& x, const double& param), const double& param, double xa, double xb, const double& xtol, const double& ftol, double& root);
+
 /**
  * @brief      Find the root of a function f(x, k) in a given interval [xa, xb]
  *             using secant method. k is simply passed to the function.
@@ -0,0 +1,40 @@
+/**
+ * @file root_method.hpp
+ *
+ * @brief      Root finding methods selectable in findRoots().
+ *
+ * @author     Francesco Marchisotti
+ *
+ * @date       17/10/2026
+ */
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief      The methods used by findRoots() to refine the brackets.
+ */
+enum class RootMethod { bisection, falsePosition, secant, newton, brent, illinois };
+
+/**
+ * @brief      Converts the name of a method to a RootMethod.
+ *
+ * @param[in]  method  The name of the method. Accepted values are:
+ *                     `bisection`, `falsePosition`, `secant`, `newton`,
+ *                     `brent`, `illinois`.
+ *
+ * @return     The corresponding RootMethod.
+ *
+ * @throws     std::invalid_argument  Thrown if `method` is not among the
+ *                                    accepted values.
+ */
+inline RootMethod rootMethod(const std::string& method) {
+	if (method == "bisection") return RootMethod::bisection;
+	if (method == "falsePosition") return RootMethod::falsePosition;
+	if (method == "secant") return RootMethod::secant;
+	if (method == "newton") return RootMethod::newton;
+	if (method == "brent") return RootMethod::brent;
+	if (method == "illinois") return RootMethod::illinois;
+	throw std::invalid_argument("Invalid method argument.");
+}
@@ -2,33 +2,37 @@
 
 void linearBVP(double (*RHS)(const double &x), double y[], const double &xL,
                const double &xR, const double &yL, const double &yR,
-               const int &nPoints) {
-	const int maxSize = 4096;
-	if (nPoints > maxSize)
-		throw std::invalid_argument(
-			"Number of equations must not be greater than " +
-			std::to_string(maxSize) + ".");
+               const int &nPoints, double work[]) {
+	if (nPoints < 3)
+		throw std::invalid_argument("Number of points must be at least 3.");
 
 	y[0]            = yL;
 	y[nPoints - 1]  = yR;
 	const double dx = (xR - xL) / (nPoints - 1);
 
-	double a[maxSize], b[maxSize], c[maxSize], r[maxSize];
-	for (int i = 0; i < nPoints; i++) {
-		a[i] = 1.0;
-		b[i] = -2.0;
-		c[i] = 1.0;
-		r[i] = dx * dx * RHS(xL + i * dx);
+	// Unknowns are y[1], ..., y[nPoints - 2]; the boundary conditions are
+	// moved to the constant vector, which is built directly in y
+	double *x     = y + 1;
+	double *h     = work;
+	const int nEq = nPoints - 2;
+	for (int i = 0; i < nEq; i++) x[i] = dx * dx * RHS(xL + (i + 1) * dx);
+	x[0] -= yL;
+	x[nEq - 1] -= yR;
+
+	// Thomas algorithm with a = c = 1, b = -2
+	h[0] = -0.5;
+	x[0] *= -0.5;
+	for (int i = 1; i < nEq; i++) {
+		double den = 1.0 / (-2.0 - h[i - 1]);
+		h[i]       = den;
+		x[i]       = (x[i] - x[i - 1]) * den;
 	}
-	r[1] -= y[0];
-	r[nPoints - 2] -= y[nPoints - 1];
-	// Required by tridiagonalSolver
-	a[0] = a[1]    = nan("");
-	c[nPoints - 1] = c[nPoints - 2] = nan("");
+	for (int i = nEq - 2; i >= 0; i--) x[i] -= h[i] * x[i + 1];
+}
 
-	// Pass arrays + 1  (i.e.: arrays starting as index 1)
-	//      nPoints - 2 (to stop at penultimate index)
-	// Effectively, we're declaring the arrays 2 longer than we need them, then
-	// scrapping the first and last element (the boundary conditions)
-	tridiagonalSolver(a + 1, b + 1, c + 1, r + 1, y + 1, nPoints - 2);
+void linearBVP(double (*RHS)(const double &x), double y[], const double &xL,
+               const double &xR, const double &yL, const double &yR,
+               const int &nPoints) {
+	std::vector<double> work(nPoints);
+	linearBVP(RHS, y, xL, xR, yL, yR, nPoints, work.data());
 }
@@ -2,119 +2,226 @@
 
 #include "../include/debug.hpp"
 
+#include <memory>
+#include <vector>
+
+// Steppers of the calling thread, one per nesting depth of the free step
+// functions, and the current depth
+static thread_local std::vector<std::unique_ptr<ODEStepper>> localSteppers;
+static thread_local size_t localDepth = 0;
+
+LocalStepper::LocalStepper(const int &neq) {
+	if (localDepth == localSteppers.size())
+		localSteppers.emplace_back(new ODEStepper());
+	stepper_ = localSteppers[localDepth].get();
+	stepper_->resize(neq);
+	localDepth++;
+}
+
+LocalStepper::~LocalStepper() {
+	localDepth--;
+}
+
 void eulerStep(const double &t, double Y[],
                void (*RHSFunc)(const double &t, double Y[], double RHS[]),
                const double &dt, const int &neq) {
-	if (neq > 64) throw std::invalid_argument("neq must be less than 64");
-
-	double rhs[64];
-
-	RHSFunc(t, Y, rhs);
-	for (int i = 0; i < neq; i++) Y[i] += dt * rhs[i];
+	LocalStepper(neq)->euler(t, Y, RHSFunc, dt);
 }
 
 void rk2Step(const double &t, double Y[],
              void (*RHSFunc)(const double &t, double Y[], double RHS[]),
              const double &dt, const int &neq, bool rule) {
-	if (neq > 64) throw std::invalid_argument("neq must be less than 64");
-	double Ystar[64], k1[64], k2[64];
-
-	if (!rule) {
-		// Midpoint
-		RHSFunc(t, Y, k1);
-
-		for (int i = 0; i < neq; i++) Ystar[i] = Y[i] + 0.5 * dt * k1[i];
-		RHSFunc(t + 0.5 * dt, Ystar, k2);
-
-		for (int i = 0; i < neq; i++) Y[i] += dt * k2[i];
-	} else {
-		// Modified Euler
-		RHSFunc(t, Y, k1);
-
-		for (int i = 0; i < neq; i++) Ystar[i] = Y[i] + dt * k1[i];
-		RHSFunc(t + dt, Ystar, k2);
-
-		for (int i = 0; i < neq; i++) Y[i] += dt * 0.5 * (k1[i] + k2[i]);
-	}
+	LocalStepper(neq)->rk2(t, Y, RHSFunc, dt, rule);
 }
 
 void rk4Step(const double &t, double Y[],
              void (*RHSFunc)(const double &t, double Y[], double RHS[]),
              const double &dt, const int &neq) {
-	if (neq > 64) throw std::invalid_argument("neq must be less than 64");
-
-	double Ystar[64], k1[64], k2[64], k3[64], k4[64];
-
-	RHSFunc(t, Y, k1);
-
-	for (int i = 0; i < neq; i++) Ystar[i] = Y[i] + 0.5 * dt * k1[i];
-	RHSFunc(t + 0.5 * dt, Ystar, k2);
-
-	for (int i = 0; i < neq; i++) Ystar[i] = Y[i] + 0.5 * dt * k2[i];
-	RHSFunc(t + 0.5 * dt, Ystar, k3);
-
-	for (int i = 0; i < neq; i++) Ystar[i] = Y[i] + dt * k3[i];
-	RHSFunc(t + dt, Ystar, k4);
-
-	for (int i = 0; i < neq; i++)
-		Y[i] += dt / 6.0 * (k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + k4[i]);
+	LocalStepper(neq)->rk4(t, Y, RHSFunc, dt);
 }
 
 void pVerlet(const double &t, double Y[],
              void (*RHSFunc)(double Y[], double RHS[]), const double &dt,
              const int &nEq) {
-	const int nMax = 64;
-	if (nEq > 64)
-		throw std::invalid_argument("nEq must be less than " +
-		                            std::to_string(nMax) + ".");
-	if (nEq % 2 != 0) throw std::invalid_argument("nEq must be even");
+	LocalStepper(nEq)->pVerlet(t, Y, RHSFunc, dt);
+}
 
-	double a[nMax / 2];
+void vVerlet(const double &t, double Y[],
+             void (*RHSFunc)(double Y[], double RHS[]), const double &dt,
+             const int &nEq) {
+	LocalStepper(nEq)->vVerlet(t, Y, RHSFunc, dt);
+}
 
-	int nParticles = nEq / 2;
+// =====================================================================================================================
+// ODEStepper
+// =====================================================================================================================
 
-	double *x = Y;
-	double *v = Y + nParticles;
+ODEStepper::ODEStepper(const int &neq) { resize(neq); }
 
-	for (int i = 0; i < nParticles; i++) x[i] += 0.5 * dt * v[i];
+ODEStepper::~ODEStepper() {
+	::operator delete[](buffer_, std::align_val_t(alignment_));
+}
 
-	RHSFunc(Y, a);
+void ODEStepper::resize(const int &neq) {
+	if (neq < 0) throw std::invalid_argument("neq must not be negative");
 
-	for (int i = 0; i < nParticles; i++) {
-		// Note: index of a is the index of the velocities
-		v[i] += dt * (a + nParticles)[i];
-		x[i] += 0.5 * dt * v[i];
+	if (neq > capacity_) {
+		// Round up each array to a whole number of cache lines
+		const int perLine       = alignment_ / sizeof(double);
+		const int stride        = (neq + perLine - 1) / perLine * perLine;
+		const std::size_t bytes = nArrays_ * stride * sizeof(double);
+		void *memory = ::operator new[](bytes, std::align_val_t(alignment_));
+
+		::operator delete[](buffer_, std::align_val_t(alignment_));
+		buffer_   = static_cast<double *>(memory);
+		stride_   = stride;
+		capacity_ = neq;
 	}
+	neq_ = neq;
 }
 
-void vVerlet(const double &t, double Y[],
-             void (*RHSFunc)(double Y[], double RHS[]), const double &dt,
-             const int &nEq) {
-	const int nMax = 64;
-	if (nEq > 64)
-		throw std::invalid_argument("nEq must be less than " +
-		                            std::to_string(nMax) + ".");
-	if (nEq % 2 != 0) throw std::invalid_argument("nEq must be even");
+// =====================================================================================================================
+// DormandPrince
+// =====================================================================================================================
+
+DormandPrince::DormandPrince(const int &neq, const double &atol,
+                             const double &rtol)
+	: neq_(neq), atol_(atol), rtol_(rtol), k_(7 * neq), cont_(5 * neq),
+	  yNew_(neq), yErr_(neq), yEvent_(neq) {
+	if (neq <= 0) throw std::invalid_argument("neq must be positive");
+	if (atol <= 0.0 && rtol <= 0.0)
+		throw std::invalid_argument("At least one tolerance must be positive");
+}
+
+double DormandPrince::errorNorm(const double Y[]) const {
+	double err = 0.0;
+	for (int i = 0; i < neq_; i++) {
+		const double sc =
+			atol_ + rtol_ * std::max(fabs(Y[i]), fabs(yNew_[i]));
+		err += (yErr_[i] / sc) * (yErr_[i] / sc);
+	}
+	return sqrt(err / neq_);
+}
+
+void DormandPrince::denseOutput(const double &t, double Y[]) const {
+	for (int i = 0; i < neq_; i++) Y[i] = denseOutput(t, i);
+}
 
-	double a[nMax / 2];
+double DormandPrince::denseOutput(const double &t, const int &i) const {
+	if (!hasStep_) throw std::runtime_error("No step has been taken yet.");
 
-	int nParticles = nEq / 2;
+	const double h   = tNew_ - tOld_;
+	const double tol = 1e-12 * std::max(fabs(tOld_), fabs(tNew_)) + 1e-300;
+	if ((t - tOld_) * (t - tNew_) > tol * fabs(h))
+		throw std::invalid_argument("t must be inside the last step.");
 
-	double *x = Y;
-	double *v = Y + nParticles;
+	return interpolate(h != 0.0 ? (t - tOld_) / h : 1.0, i);
+}
 
-	RHSFunc(Y, a);
+double DormandPrince::interpolate(const double &theta, const int &i) const {
+	const double *r = cont_.data() + i;
+	const double theta1 = 1.0 - theta;
+	return r[0] +
+	       theta *
+	           (r[neq_] +
+	            theta1 * (r[2 * neq_] +
+	                      theta * (r[3 * neq_] + theta1 * r[4 * neq_])));
+}
 
-	for (int i = 0; i < nParticles; i++) {
-		// Note: index of a is the index of the velocities
-		v[i] += 0.5 * dt * (a + nParticles)[i];
-		x[i] += dt * v[i];
+int DormandPrince::addEvent(const EventFunc &g, const int &direction,
+                            const int &stopAfter) {
+	if (!g) throw std::invalid_argument("Event function is empty.");
+	if (stopAfter < 0)
+		throw std::invalid_argument("stopAfter must be non-negative.");
+	events_.push_back({g, direction, stopAfter, 0, 0.0});
+	return static_cast<int>(events_.size()) - 1;
+}
+
+void DormandPrince::clearEvents() {
+	events_.clear();
+	eventLog_.clear();
+}
+
+int DormandPrince::eventCount(const int &id) const {
+	if (id < 0 || id >= static_cast<int>(events_.size()))
+		throw std::out_of_range("Invalid event id.");
+	return events_[id].count;
+}
+
+void DormandPrince::initEvents(const double &t, const double Y[]) {
+	eventLog_.clear();
+	stopped_ = false;
+	for (Event &ev : events_) {
+		ev.count = 0;
+		ev.gOld  = ev.g(t, Y);
 	}
+}
 
-	RHSFunc(Y, a);
+bool DormandPrince::checkEvents(double &t, double Y[]) {
+	// Events whose function crossed zero in the step, sorted by time
+	const int first = static_cast<int>(eventLog_.size());
+	for (int id = 0; id < static_cast<int>(events_.size()); id++) {
+		Event &ev         = events_[id];
+		const double gNew = ev.g(t, Y);
+		const bool up     = ev.gOld < 0.0 && gNew >= 0.0;
+		const bool down   = ev.gOld > 0.0 && gNew <= 0.0;
+		if ((up && ev.direction >= 0) || (down && ev.direction <= 0)) {
+			double tHit = tNew_;
+			if (gNew == 0.0) std::copy(Y, Y + neq_, yEvent_.begin());
+			else tHit = tOld_ + locateEvent(id, ev.gOld, gNew) * (tNew_ - tOld_);
+			eventLog_.push_back({id, tHit, yEvent_});
+		}
+		ev.gOld = gNew;
+	}
+	const bool forward = tNew_ >= tOld_;
+	std::sort(eventLog_.begin() + first, eventLog_.end(),
+	          [&](const EventHit &a, const EventHit &b) {
+				  return forward ? a.t < b.t : a.t > b.t;
+			  });
+
+	// Count the occurrences in order, stopping at the first terminal one
+	for (int j = first; j < static_cast<int>(eventLog_.size()); j++) {
+		Event &ev = events_[eventLog_[j].id];
+		ev.count++;
+		if (ev.stopAfter > 0 && ev.count == ev.stopAfter) {
+			eventLog_.resize(j + 1);
+			t = eventLog_[j].t;
+			std::copy(eventLog_[j].Y.begin(), eventLog_[j].Y.end(), Y);
+			stopped_ = true;
+			return true;
+		}
+	}
+	return false;
+}
 
-	for (int i = 0; i < nParticles; i++) {
-		// Note: index of a is the index of the velocities
-		v[i] += 0.5 * dt * (a + nParticles)[i];
+double DormandPrince::locateEvent(const int &id, double gOld, double gNew) {
+	const EventFunc &g = events_[id].g;
+	const double h     = tNew_ - tOld_;
+
+	// Illinois method on theta in [0, 1]; b always stays past the crossing
+	double a = 0.0, b = 1.0;
+	int side = 0;
+	for (int iter = 0; iter < 100 && b - a > 4.0 * 2.2e-16; iter++) {
+		double c = (a * gNew - b * gOld) / (gNew - gOld);
+		if (c <= a || c >= b) c = 0.5 * (a + b);
+
+		for (int i = 0; i < neq_; i++) yEvent_[i] = interpolate(c, i);
+		const double gc = g(tOld_ + c * h, yEvent_.data());
+
+		if (gc == 0.0 || (gc > 0.0) == (gNew > 0.0)) {
+			b    = c;
+			gNew = gc;
+			if (gc == 0.0) break;
+			if (side == -1) gOld *= 0.5;
+			side = -1;
+		} else {
+			a    = c;
+			gOld = gc;
+			if (side == 1) gNew *= 0.5;
+			side = 1;
+		}
 	}
+
+	for (int i = 0; i < neq_; i++) yEvent_[i] = interpolate(b, i);
+	return b;
 }
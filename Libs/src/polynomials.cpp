@@ -1,6 +1,12 @@
 #include "../include/polynomials.hpp"
 
 #include "../include/debug.hpp"
+#include "../include/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 
 double hornerPol(const double &x, const double a[], const int &degree,
                  double &dpdx) {
@@ -19,20 +25,194 @@ double hornerPol(const double &x, const double a[], const int &degree) {
 	return p;
 }
 
-double hornerPol(const double &x, const std::vector<double> a, double &dpdx) {
-	int degree = a.size();
-	double p   = a[degree];
-	dpdx       = 0.0;
-	for (int i = degree - 1; i >= 0; i--) {
-		dpdx = dpdx * x + p;
-		p    = p * x + a[i];
+double hornerPol(const double &x, const std::vector<double> &a, double &dpdx) {
+	if (a.empty()) {
+		dpdx = 0.0;
+		return 0.0;
 	}
-	return p;
+	return hornerPol(x, a.data(), static_cast<int>(a.size()) - 1, dpdx);
 }
 
-double hornerPol(const double &x, const std::vector<double> a) {
-	int degree = a.size();
-	double p   = a[degree];
-	for (int i = degree - 1; i >= 0; i--) p = p * x + a[i];
-	return p;
+double hornerPol(const double &x, const std::vector<double> &a) {
+	if (a.empty()) return 0.0;
+	return hornerPol(x, a.data(), static_cast<int>(a.size()) - 1);
+}
+
+void hornerPol(const double x[], double p[], const int &n, const double a[],
+               const int &degree) {
+	const int blockSize = 256;
+	double xb[blockSize];
+
+	for (int j0 = 0; j0 < n; j0 += blockSize) {
+		const int m = std::min(blockSize, n - j0);
+		double *pb  = p + j0;
+
+		// Copy the points first, since p can be the same array as x
+		std::copy(x + j0, x + j0 + m, xb);
+		for (int j = 0; j < m; j++) pb[j] = a[degree];
+		for (int i = degree - 1; i >= 0; i--) {
+			const double ai = a[i];
+			for (int j = 0; j < m; j++) pb[j] = pb[j] * xb[j] + ai;
+		}
+	}
+}
+
+void hornerPol(const double x[], double p[], double dpdx[], const int &n,
+               const double a[], const int &degree) {
+	const int blockSize = 256;
+
+	for (int j0 = 0; j0 < n; j0 += blockSize) {
+		const int m     = std::min(blockSize, n - j0);
+		const double *xb = x + j0;
+		double *pb       = p + j0;
+		double *db       = dpdx + j0;
+
+		for (int j = 0; j < m; j++) {
+			pb[j] = a[degree];
+			db[j] = 0.0;
+		}
+		for (int i = degree - 1; i >= 0; i--) {
+			const double ai = a[i];
+			for (int j = 0; j < m; j++) {
+				db[j] = db[j] * xb[j] + pb[j];
+				pb[j] = pb[j] * xb[j] + ai;
+			}
+		}
+	}
+}
+
+/**
+ * @brief      Evaluates a[0] + a[1] x + ... + a[m - 1] x^(m - 1) with Estrin
+ *             scheme, given pw[k] = x^(2^k).
+ */
+static double estrin(const double a[], const int &m, const double pw[]) {
+	if (m == 1) return a[0];
+	if (m == 2) return a[0] + a[1] * pw[0];
+
+	// Split at the largest power of two h < m
+	int k = 0;
+	while ((2 << k) < m) k++;
+	const int h = 1 << k;
+	return estrin(a, h, pw) + pw[k] * estrin(a + h, m - h, pw);
+}
+
+double estrinPol(const double &x, const double a[], const int &degree) {
+	// Powers x^(2^k), enough for any int degree
+	double pw[32];
+	pw[0] = x;
+	for (int k = 1; (1 << k) <= degree && k < 31; k++) pw[k] = pw[k - 1] * pw[k - 1];
+
+	return estrin(a, degree + 1, pw);
+}
+
+double estrinPol(const double &x, const std::vector<double> &a) {
+	if (a.empty()) return 0.0;
+	return estrinPol(x, a.data(), static_cast<int>(a.size()) - 1);
+}
+
+/**
+ * @brief      Aberth-Ehrlich iteration on the polynomial a[0..n] with
+ *             a[0] != 0 and a[n] != 0. Writes the n roots in z.
+ */
+static void aberth(const double a[], const int &n, std::complex<double> z[],
+                   const int &maxIter) {
+	typedef std::complex<double> cplx;
+	const double eps = std::numeric_limits<double>::epsilon();
+
+	if (n == 1) {
+		z[0] = -a[0] / a[1];
+		return;
+	}
+
+	// Initial guesses on a circle around the centroid of the roots, with the
+	// radius given by Fujiwara bound. The angular offset keeps the guesses
+	// off the real axis, where the iteration of a real polynomial would stay.
+	const double centre = -a[n - 1] / (n * a[n]);
+	double radius       = 0.0;
+	for (int i = 0; i < n; i++) {
+		const double ri = std::pow(std::abs(a[i] / a[n]), 1.0 / (n - i));
+		radius          = std::max(radius, i == 0 ? std::pow(0.5, 1.0 / n) * ri : ri);
+	}
+	radius *= 2.0;
+	for (int k = 0; k < n; k++) {
+		z[k] = centre + std::polar(radius, 2.0 * M_PI * k / n + 0.4);
+	}
+
+	std::vector<bool> converged(n, false);
+	int nConverged = 0;
+	for (int iter = 0; iter < maxIter; iter++) {
+		for (int k = 0; k < n; k++) {
+			if (converged[k]) continue;
+
+			// Polynomial, derivative and rounding error bound at z[k]
+			cplx p      = a[n];
+			cplx dp     = 0.0;
+			double bound = std::abs(a[n]);
+			const double az = std::abs(z[k]);
+			for (int i = n - 1; i >= 0; i--) {
+				dp    = dp * z[k] + p;
+				p     = p * z[k] + a[i];
+				bound = bound * az + std::abs(a[i]);
+			}
+			// Once the value is within rounding of zero, the step is taken one
+			// last time, since it still improves a well conditioned root
+			const bool small = std::abs(p) <= 4.0 * n * eps * bound;
+
+			cplx s = 0.0;
+			for (int j = 0; j < n; j++) {
+				if (j != k) s += 1.0 / (z[k] - z[j]);
+			}
+			cplx den = dp - p * s;
+			if (den == 0.0) den = eps * bound;
+			const cplx w = p / den;
+			z[k] -= w;
+			if (small || std::abs(w) <= eps * std::abs(z[k])) {
+				converged[k] = true;
+				nConverged++;
+			}
+		}
+		if (nConverged == n) return;
+	}
+	throw std::runtime_error("Maximum number of steps exceeded.");
+}
+
+/**
+ * @brief      Finds the roots of a[0..degree], deflating the zero roots first.
+ */
+static void polRootsImpl(const double a[], const int &degree,
+                         std::complex<double> roots[], const int &maxIter) {
+	if (degree < 1) throw std::invalid_argument("degree must be positive");
+	if (a[degree] == 0.0)
+		throw std::invalid_argument("Leading coefficient must be non zero.");
+
+	int nZero = 0;
+	while (a[nZero] == 0.0) roots[nZero++] = 0.0;
+	if (nZero < degree)
+		aberth(a + nZero, degree - nZero, roots + nZero, maxIter);
+}
+
+std::vector<std::complex<double>> polRoots(const double a[], const int &degree,
+                                           const int &maxIter) {
+	std::vector<std::complex<double>> roots(std::max(degree, 0));
+	polRootsImpl(a, degree, roots.data(), maxIter);
+	return roots;
+}
+
+std::vector<std::complex<double>> polRoots(const std::vector<double> &a,
+                                           const int &maxIter) {
+	return polRoots(a.data(), static_cast<int>(a.size()) - 1, maxIter);
+}
+
+void polRoots(const double a[], const int &degree, const int &nPol,
+              std::complex<double> roots[], const int &maxIter,
+              const int nThreads) {
+	if (degree < 1) throw std::invalid_argument("degree must be positive");
+	parallelFor(
+		0, nPol,
+		[&](const int &k0, const int &k1) {
+			for (int k = k0; k < k1; k++)
+				polRootsImpl(a + k * (degree + 1), degree, roots + k * degree,
+		                     maxIter);
+		},
+		nThreads);
 }
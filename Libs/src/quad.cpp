@@ -2,142 +2,151 @@
 
 #include "../include/debug.hpp"
 
-double rectangularQuad(double (*F)(const double &x), const double &a,
-                       const double &b, const int &n) {
-	double sum     = 0.0;
-	const double h = (b - a) / n;  // Interval width
-	double xi      = a;
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <stdexcept>
 
-	for (int i = 0; i < n; i++) {  // Rectangular rule
-		sum += F(xi);
-		xi += h;
-	}
+double rectangularQuad(double (*F)(const double &x), const double &a,
+                       const double &b, const int &n, const int nThreads) {
+	return rectangularQuad<double (*)(const double &)>(F, a, b, n, nThreads);
+}
 
-	return sum * h;  // Finalise the calculation and return
+double rectangularQuad(void (*F)(const double x[], double fx[], const int &n),
+                       const double &a, const double &b, const int &n,
+                       const int nThreads) {
+	return rectangularQuad<void (*)(const double[], double[], const int &)>(
+		F, a, b, n, nThreads);
 }
 
 double midpointQuad(double (*F)(const double &x), const double &a,
-                    const double &b, const int &n) {
+                    const double &b, const int &n, const int nThreads) {
 	// Gauss-Legendre rule converges to midpoint rule for Ng = 1
-	return gaussLegendreQuad(F, a, b, n, 1);
+	return gaussLegendreQuad(F, a, b, n, 1, nThreads);
 }
 
-double trapezoidalQuad(double (*F)(const double &x), const double &a,
-                       const double &b, const int &n) {
-	double sum = 0.5 * (F(a) + F(b));  // Take care of the first and last
-	                                   // term of the summation
-	const double h = (b - a) / n;      // Interval width
-	double xi      = a;
+double midpointQuad(void (*F)(const double x[], double fx[], const int &n),
+                    const double &a, const double &b, const int &n,
+                    const int nThreads) {
+	return gaussLegendreQuad(F, a, b, n, 1, nThreads);
+}
 
-	for (int i = 1; i < n; i++) {  // Trapezoidal rule
-		xi += h;
-		sum += F(xi);
-	}
+double trapezoidalQuad(double (*F)(const double &x), const double &a,
+                       const double &b, const int &n, const int nThreads) {
+	return trapezoidalQuad<double (*)(const double &)>(F, a, b, n, nThreads);
+}
 
-	return sum * h;  // Finalise the calculation and return
+double trapezoidalQuad(void (*F)(const double x[], double fx[], const int &n),
+                       const double &a, const double &b, const int &n,
+                       const int nThreads) {
+	return trapezoidalQuad<void (*)(const double[], double[], const int &)>(
+		F, a, b, n, nThreads);
 }
 
 double simpsonQuad(double (*F)(const double &x), const double &a,
-                   const double &b, const int &n) {
-	// n must be even!
-	if (n % 2 != 0) {
-		throw std::invalid_argument(
-			"simpsonQuad(): Invalid argument: n must be even.");
-	}
+                   const double &b, const int &n, const int nThreads) {
+	return simpsonQuad<double (*)(const double &)>(F, a, b, n, nThreads);
+}
+
+double simpsonQuad(void (*F)(const double x[], double fx[], const int &n),
+                   const double &a, const double &b, const int &n,
+                   const int nThreads) {
+	return simpsonQuad<void (*)(const double[], double[], const int &)>(
+		F, a, b, n, nThreads);
+}
 
-	const double h = (b - a) / n;  // Interval width
-	double sum     = F(a) + F(b);  // Take care of the first and last term of
-	                               // the summation
-	double xi = a;
-	double w  = 4.0;  // Define the second weight to be 4
+/**
+ * @brief      Computes the Gauss-Legendre rule with Ng points.
+ */
+static GaussLegendreRule computeGaussLegendreRule(const int &Ng) {
+	GaussLegendreRule rule;
+	rule.weights.reserve(Ng);
+	rule.roots.reserve(Ng);
+
+	if (Ng % 2 != 0) {
+		// P_Ng'(0) from the recurrence on the central coefficients
+		double dp = 1.0;
+		for (int k = 1; k < Ng; k += 2) dp *= -static_cast<double>(k) / (k + 1);
+		dp *= Ng;
+		rule.roots.push_back(0.0);
+		rule.weights.push_back(2.0 / (dp * dp));
+	}
 
-	for (int i = 1; i < n; i++) {
-		xi += h;
-		sum += F(xi) * w;
-		w = 6.0 - w;  // Alternate between w = 4 and w = 2
+	// Positive roots, from the smallest to the largest
+	for (int k = Ng / 2; k >= 1; k--) {
+		double x  = cos(M_PI * (k - 0.25) / (Ng + 0.5));  // Initial guess
+		double dp = 0.0;
+		for (int iter = 0; iter < 100; iter++) {
+			// Legendre recurrence: P_Ng(x) and P_Ng-1(x)
+			double p0 = 1.0, p1 = x;
+			for (int j = 2; j <= Ng; j++) {
+				const double p2 = ((2 * j - 1) * x * p1 - (j - 1) * p0) / j;
+				p0              = p1;
+				p1              = p2;
+			}
+			dp              = Ng * (x * p1 - p0) / (x * x - 1.0);
+			const double dx = p1 / dp;
+			x -= dx;
+			if (fabs(dx) <= 1e-16) break;
+		}
+		const double w = 2.0 / ((1.0 - x * x) * dp * dp);
+		rule.roots.push_back(x);
+		rule.weights.push_back(w);
+		rule.roots.push_back(-x);
+		rule.weights.push_back(w);
 	}
 
-	return sum * h / 3;  // Finalise the calculation and return
+	return rule;
+}
+
+const GaussLegendreRule &gaussLegendreRule(const int &Ng) {
+	if (Ng < 1)
+		throw std::invalid_argument("gaussLegendreRule(): Invalid argument: "
+		                            "Ng must be positive.");
+
+	// std::map never moves its elements, so the references stay valid
+	static std::map<int, GaussLegendreRule> cache;
+	static std::mutex cacheMutex;
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	auto it = cache.find(Ng);
+	if (it == cache.end())
+		it = cache.emplace(Ng, computeGaussLegendreRule(Ng)).first;
+	return it->second;
 }
 
 void setLegendreWeightsAndRoots(double weights[], double roots[],
                                 const int &Ng) {
-	switch (Ng) {
-	case 1:
-		roots[0]   = 0;
-		weights[0] = 2;
-		break;
-	case 2:
-		roots[0]   = sqrt(1.0 / 3.0);
-		weights[0] = 1;
-		roots[1]   = -sqrt(1.0 / 3.0);
-		weights[1] = 1;
-		break;
-	case 3:
-		roots[0]   = 0;
-		weights[0] = 8.0 / 9.0;
-		roots[1]   = sqrt(3.0 / 5.0);
-		weights[1] = 5.0 / 9.0;
-		roots[2]   = -sqrt(3.0 / 5.0);
-		weights[2] = 5.0 / 9.0;
-		break;
-	case 4:
-		roots[0]   = sqrt(3.0 / 7.0 - 2.0 / 7.0 * sqrt(6.0 / 5.0));
-		weights[0] = (18 + sqrt(30)) / 36;
-		roots[1]   = -sqrt(3.0 / 7.0 - 2.0 / 7.0 * sqrt(6.0 / 5.0));
-		weights[1] = (18 + sqrt(30)) / 36;
-		roots[2]   = sqrt(3.0 / 7.0 + 2.0 / 7.0 * sqrt(6.0 / 5.0));
-		weights[2] = (18 - sqrt(30)) / 36;
-		roots[3]   = -sqrt(3.0 / 7.0 + 2.0 / 7.0 * sqrt(6.0 / 5.0));
-		weights[3] = (18 - sqrt(30)) / 36;
-		break;
-	case 5:
-		roots[0]   = 0;
-		weights[0] = 128.0 / 225.0;
-		roots[1]   = 1.0 / 3.0 * sqrt(5 - 2 * sqrt(10.0 / 7.0));
-		weights[1] = (322.0 + 13.0 * sqrt(70.0)) / 900.0;
-		roots[2]   = -1.0 / 3.0 * sqrt(5 - 2 * sqrt(10.0 / 7.0));
-		weights[2] = (322.0 + 13.0 * sqrt(70.0)) / 900.0;
-		roots[3]   = 1.0 / 3.0 * sqrt(5 + 2 * sqrt(10.0 / 7.0));
-		weights[3] = (322.0 - 13.0 * sqrt(70.0)) / 900.0;
-		roots[4]   = -1.0 / 3.0 * sqrt(5 + 2 * sqrt(10.0 / 7.0));
-		weights[4] = (322.0 - 13.0 * sqrt(70.0)) / 900.0;
-		break;
-	default:
+	if (Ng < 1)
 		throw std::invalid_argument("setLegendreWeightsAndRoots(): Invalid "
-		                            "argument: Ng must be in [1, 5].");
-	}
+		                            "argument: Ng must be positive.");
+
+	const GaussLegendreRule &rule = gaussLegendreRule(Ng);
+	std::copy(rule.weights.begin(), rule.weights.end(), weights);
+	std::copy(rule.roots.begin(), rule.roots.end(), roots);
 }
 
 double gaussLegendreQuad(double (*F)(const double &x), const double &a,
-                         const double &b, const int N, const int Ng) {
-	double weight[8], root[8];
-
-	setLegendreWeightsAndRoots(weight, root, Ng);
-
-	const double h = (b - a) / N;  // Interval width
-	double sum     = 0.0;
-
-	double xc, sumj;
-
-	for (int i = 0; i < N; i++) {     // Loop over intervals
-		xc   = a + (i + 0.5) * h;     // Define the centre of the interval
-		sumj = 0.0;                   // Initialize sum for this interval
-		for (int j = 0; j < Ng; j++)  // Loop over gaussian points in the
-		                              // interval and apply gaussian rule
-			sumj += weight[j] * F(0.5 * h * root[j] + xc);
-		sum += sumj;  // Add partial sum to total integral
-	}
+                         const double &b, const int N, const int Ng,
+                         const int nThreads) {
+	return gaussLegendreQuad<double (*)(const double &)>(F, a, b, N, Ng,
+	                                                     nThreads);
+}
 
-	return 0.5 * h * sum;  // Finalize calculation and return
+double gaussLegendreQuad(void (*F)(const double x[], double fx[],
+                                   const int &n),
+                         const double &a, const double &b, const int N,
+                         const int Ng, const int nThreads) {
+	return gaussLegendreQuad<void (*)(const double[], double[], const int &)>(
+		F, a, b, N, Ng, nThreads);
 }
 
 double gaussLegendreQuad2D(double (*F)(const double &x, const double &y),
                            const double &xa, const double &xb, const double &ya,
                            const double &yb, const int N, const int Ng) {
-	double weight[8], root[8];
-
-	setLegendreWeightsAndRoots(weight, root, Ng);
+	const GaussLegendreRule &rule = gaussLegendreRule(Ng);
+	const double *weight          = rule.weights.data();
+	const double *root            = rule.roots.data();
 
 	const double xh = (xb - xa) / N;  // Interval width along x
 	const double yh = (yb - ya) / N;  // Interval width along y
@@ -168,3 +177,548 @@ double gaussLegendreQuad2D(double (*F)(const double &x, const double &y),
 
 	return 0.25 * xh * yh * sum;  // Finalise calculation and return
 }
+
+/**
+ * @brief      Weighted sum of F over the tensor product of the axis rules,
+ *             visited as an odometer on the last axis.
+ */
+static double tensorProductSum(double (*F)(const double x[]),
+                               const std::vector<std::vector<double>> &nodes,
+                               const std::vector<std::vector<double>> &weights) {
+	const int dim = nodes.size();
+	std::vector<int> idx(dim, 0);
+	std::vector<double> x(dim), wprod(dim + 1);  // wprod[d]: axes before d
+
+	wprod[0] = 1.0;
+	for (int d = 0; d < dim; d++) {
+		x[d]         = nodes[d][0];
+		wprod[d + 1] = wprod[d] * weights[d][0];
+	}
+
+	NeumaierSum sum;
+	while (true) {
+		sum.add(wprod[dim] * F(x.data()));
+
+		// Advance the odometer and update the axes that changed
+		int d = dim - 1;
+		while (d >= 0 && ++idx[d] == static_cast<int>(nodes[d].size())) {
+			idx[d] = 0;
+			d--;
+		}
+		if (d < 0) break;
+		for (int k = d; k < dim; k++) {
+			x[k]         = nodes[k][idx[k]];
+			wprod[k + 1] = wprod[k] * weights[k][idx[k]];
+		}
+	}
+
+	return sum.value();
+}
+
+double gaussLegendreQuadND(double (*F)(const double x[]), const int &dim,
+                           const double xa[], const double xb[],
+                           const int N[], const int Ng[]) {
+	if (dim < 1)
+		throw std::invalid_argument("gaussLegendreQuadND(): Invalid argument: "
+		                            "dim must be positive.");
+
+	// Composite rule along every axis
+	std::vector<std::vector<double>> nodes(dim), weights(dim);
+	for (int d = 0; d < dim; d++) {
+		if (N[d] < 1)
+			throw std::invalid_argument("gaussLegendreQuadND(): Invalid "
+			                            "argument: N must be positive.");
+		const GaussLegendreRule &rule = gaussLegendreRule(Ng[d]);
+		const double h                = (xb[d] - xa[d]) / N[d];
+		for (int i = 0; i < N[d]; i++) {
+			const double xc = xa[d] + (i + 0.5) * h;
+			for (int j = 0; j < Ng[d]; j++) {
+				nodes[d].push_back(xc + 0.5 * h * rule.roots[j]);
+				weights[d].push_back(0.5 * h * rule.weights[j]);
+			}
+		}
+	}
+
+	return tensorProductSum(F, nodes, weights);
+}
+
+/**
+ * @brief      Binomial coefficient n over k.
+ */
+static double binomial(const int &n, const int &k) {
+	double c = 1.0;
+	for (int i = 1; i <= k; i++) c = c * (n - k + i) / i;
+	return c;
+}
+
+double smolyakQuad(double (*F)(const double x[]), const int &dim,
+                   const double xa[], const double xb[], const int &level) {
+	if (dim < 1)
+		throw std::invalid_argument("smolyakQuad(): Invalid argument: dim "
+		                            "must be positive.");
+	if (level < 1)
+		throw std::invalid_argument("smolyakQuad(): Invalid argument: level "
+		                            "must be positive.");
+
+	// Gauss-Legendre rules with 2 l - 1 points, l = 1, ..., level. All of
+	// them have the centre as a node, so the distinct nodes of an axis are
+	// numbered with the centre first: ids[l][j] is the number of the j-th node
+	// of the rule of level l
+	std::vector<double> roots(1, 0.0);
+	std::vector<std::vector<int>> ids(level + 1);
+	std::vector<std::vector<double>> ruleWeights(level + 1);
+	for (int l = 1; l <= level; l++) {
+		const GaussLegendreRule &rule = gaussLegendreRule(2 * l - 1);
+		for (int j = 0; j < 2 * l - 1; j++) {
+			if (rule.roots[j] == 0.0) {
+				ids[l].push_back(0);
+			} else {
+				ids[l].push_back(roots.size());
+				roots.push_back(rule.roots[j]);
+			}
+			ruleWeights[l].push_back(rule.weights[j]);
+		}
+	}
+
+	// Combination technique: all l with l[d] >= 1 and
+	// level <= |l| <= q = level + dim - 1, visited as an odometer. The
+	// weights of the points shared by more tensor products are summed, so
+	// that every distinct point is evaluated once
+	const int q = level + dim - 1;
+	std::map<std::vector<int>, double> points;
+	std::vector<int> l(dim, 1), idx(dim), point(dim);
+	int norm = dim;  // |l|
+	while (true) {
+		if (norm >= level) {
+			const double coeff =
+				((q - norm) % 2 == 0 ? 1.0 : -1.0) * binomial(dim - 1, q - norm);
+
+			// Tensor product of the rules of levels l
+			std::fill(idx.begin(), idx.end(), 0);
+			while (true) {
+				double w = coeff;
+				for (int d = 0; d < dim; d++) {
+					point[d] = ids[l[d]][idx[d]];
+					w *= ruleWeights[l[d]][idx[d]];
+				}
+				points[point] += w;
+
+				int d = dim - 1;
+				while (d >= 0 && ++idx[d] == 2 * l[d] - 1) {
+					idx[d] = 0;
+					d--;
+				}
+				if (d < 0) break;
+			}
+		}
+
+		// Next l with |l| <= q
+		int d = dim - 1;
+		while (d >= 0 && norm == q) {
+			norm -= l[d] - 1;
+			l[d] = 1;
+			d--;
+		}
+		if (d < 0) break;
+		l[d]++;
+		norm++;
+	}
+
+	// Evaluate the integrand on the distinct points, mapped on the box
+	std::vector<double> x(dim);
+	double volume = 1.0;
+	for (int d = 0; d < dim; d++) volume *= 0.5 * (xb[d] - xa[d]);
+	NeumaierSum sum;
+	for (const std::pair<const std::vector<int>, double> &p : points) {
+		if (p.second == 0.0) continue;
+		for (int d = 0; d < dim; d++)
+			x[d] = 0.5 * (xa[d] + xb[d]) + 0.5 * (xb[d] - xa[d]) * roots[p.first[d]];
+		sum.add(p.second * F(x.data()));
+	}
+
+	return volume * sum.value();
+}
+
+double rombergQuad(double (*F)(const double &x), const double &a,
+                   const double &b, const double &tol, double &err,
+                   const int &maxLevel) {
+	if (maxLevel < 1)
+		throw std::invalid_argument("rombergQuad(): Invalid argument: "
+		                            "maxLevel must be positive.");
+
+	// Two rows of the Richardson table
+	std::vector<double> previous(maxLevel + 1), current(maxLevel + 1);
+
+	double h    = b - a;  // Step of the trapezoidal rule
+	previous[0] = 0.5 * h * (F(a) + F(b));
+	err         = 0.0;
+
+	long long n = 1;  // Number of new midpoints
+	int level   = 0;  // Last complete row of the table
+	for (int k = 1; k <= maxLevel; k++) {
+		// Trapezoidal rule with half the step, from the new midpoints only
+		auto midpoints = [&](const long long &i0, const int &m, double x[],
+		                     double w[]) {
+			for (int j = 0; j < m; j++) {
+				x[j] = a + (i0 + j + 0.5) * h;
+				w[j] = 1.0;
+			}
+		};
+		current[0] =
+			0.5 * (previous[0] + h * quadWeightedSum(F, n, midpoints, 1));
+		h *= 0.5;
+		n *= 2;
+
+		// Richardson extrapolation
+		double factor = 1.0;
+		for (int j = 1; j <= k; j++) {
+			factor *= 4.0;
+			current[j] = current[j - 1] +
+			             (current[j - 1] - previous[j - 1]) / (factor - 1.0);
+		}
+
+		err = fabs(current[k] - previous[k - 1]);
+		std::swap(previous, current);
+		level = k;
+		if (k >= 2 && err <= tol) break;
+	}
+
+	return previous[level];
+}
+
+double rombergQuad(double (*F)(const double &x), const double &a,
+                   const double &b, const double &tol) {
+	double err;
+	return rombergQuad(F, a, b, tol, err);
+}
+
+// Kronrod nodes (from the largest to 0) and weights, and the weights of the
+// Gauss nodes, which are the Kronrod nodes with odd index
+static const double xgk15[] = {
+	0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+	0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+	0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+	0.207784955007898467600689403773245, 0.000000000000000000000000000000000};
+static const double wgk15[] = {
+	0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+	0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+	0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+	0.204432940075298892414161999234649, 0.209482141084727828012999174891714};
+static const double wg7[] = {
+	0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+	0.381830050505118944950369775488975, 0.417959183673469387755102040816327};
+
+static const double xgk21[] = {
+	0.995657163025808080735527280689003, 0.973906528517171720077964012084452,
+	0.930157491355708226001207180059508, 0.865063366688984510732096688423493,
+	0.780817726586416897063717578345042, 0.679409568299024406234327365114874,
+	0.562757134668604683339000099272694, 0.433395394129247190799265943165784,
+	0.294392862701460198131126603103866, 0.148874338981631210884826001129720,
+	0.000000000000000000000000000000000};
+static const double wgk21[] = {
+	0.011694638867371874278064396062192, 0.032558162307964727478818972459390,
+	0.054755896574351996031381300244580, 0.075039674810919952767043140916190,
+	0.093125454583697605535065465083366, 0.109387158802297641899210590325805,
+	0.123491976262065851077580632479260, 0.134709217311473325928054001771707,
+	0.142775938577060080797094273138717, 0.147739104901338491374841515972068,
+	0.149445554002916905664936468389821};
+static const double wg10[] = {
+	0.066671344308688137593568809893332, 0.149451349150580593145776339657697,
+	0.219086362515982043995534934228163, 0.269266719309996355091226921569469,
+	0.295524224714752870173892994651338};
+
+/**
+ * @brief      Applies the Gauss-Kronrod pair with nk Kronrod nodes on [a, b].
+ */
+static double gaussKronrodRule(double (*F)(const double &x), const double &a,
+                               const double &b, const double xgk[],
+                               const double wgk[], const double wg[],
+                               const int &nk, double &err) {
+	const double c = 0.5 * (a + b);  // Centre of the interval
+	const double h = 0.5 * (b - a);  // Half width of the interval
+
+	// The centre is a Gauss node only if its index is odd
+	const double fc = F(c);
+	double resK     = wgk[nk - 1] * fc;
+	double resG     = (nk - 1) % 2 != 0 ? wg[(nk - 1) / 2] * fc : 0.0;
+
+	for (int j = 0; j < nk - 1; j++) {
+		const double dx   = h * xgk[j];
+		const double fsum = F(c - dx) + F(c + dx);
+		resK += wgk[j] * fsum;
+		if (j % 2 != 0) resG += wg[j / 2] * fsum;
+	}
+
+	err = fabs((resK - resG) * h);
+	return resK * h;
+}
+
+/**
+ * @brief      Sub-interval of gaussKronrodQuad() with its estimates.
+ */
+struct KronrodInterval {
+	double a, b;      //!< Bounds of the sub-interval
+	double integral;  //!< Estimate of the integral
+	double err;       //!< Error estimate
+
+	bool operator<(const KronrodInterval &other) const {
+		return err < other.err;
+	}
+};
+
+double gaussKronrodQuad(double (*F)(const double &x), const double &a,
+                        const double &b, const double &tol, double &err,
+                        const int &points, const int &maxIntervals) {
+	const double *xgk, *wgk, *wg;
+	int nk;
+	switch (points) {
+	case 15:
+		xgk = xgk15;
+		wgk = wgk15;
+		wg  = wg7;
+		nk  = 8;
+		break;
+	case 21:
+		xgk = xgk21;
+		wgk = wgk21;
+		wg  = wg10;
+		nk  = 11;
+		break;
+	default:
+		throw std::invalid_argument("gaussKronrodQuad(): Invalid argument: "
+		                            "points must be 15 or 21.");
+	}
+	if (maxIntervals < 1)
+		throw std::invalid_argument("gaussKronrodQuad(): Invalid argument: "
+		                            "maxIntervals must be positive.");
+
+	// Max-heap on the error estimate
+	std::vector<KronrodInterval> heap;
+	heap.reserve(maxIntervals);
+	KronrodInterval whole = {a, b, 0.0, 0.0};
+	whole.integral =
+		gaussKronrodRule(F, a, b, xgk, wgk, wg, nk, whole.err);
+	heap.push_back(whole);
+	double totalErr = whole.err;
+
+	while (totalErr > tol && static_cast<int>(heap.size()) < maxIntervals) {
+		const KronrodInterval worst = heap.front();
+		const double mid            = 0.5 * (worst.a + worst.b);
+		if (mid <= worst.a || mid >= worst.b) break;  // Cannot split further
+
+		std::pop_heap(heap.begin(), heap.end());
+		heap.pop_back();
+
+		KronrodInterval left  = {worst.a, mid, 0.0, 0.0};
+		KronrodInterval right = {mid, worst.b, 0.0, 0.0};
+		left.integral =
+			gaussKronrodRule(F, left.a, left.b, xgk, wgk, wg, nk, left.err);
+		right.integral =
+			gaussKronrodRule(F, right.a, right.b, xgk, wgk, wg, nk, right.err);
+		heap.push_back(left);
+		std::push_heap(heap.begin(), heap.end());
+		heap.push_back(right);
+		std::push_heap(heap.begin(), heap.end());
+
+		totalErr += left.err + right.err - worst.err;
+	}
+
+	// Sum again from scratch, to drop the rounding of the running updates
+	double sum = 0.0;
+	err        = 0.0;
+	for (const KronrodInterval &interval : heap) {
+		sum += interval.integral;
+		err += interval.err;
+	}
+	return sum;
+}
+
+double gaussKronrodQuad(double (*F)(const double &x), const double &a,
+                        const double &b, const double &tol) {
+	double err;
+	return gaussKronrodQuad(F, a, b, tol, err);
+}
+
+/**
+ * @brief      Kind of double exponential map.
+ */
+enum class DoubleExpMap { tanhSinh, expSinh, sinhSinh };
+
+/**
+ * @brief      Nodes of a double exponential rule added at one level, for
+ *             t > 0. `xp`, `wp` are the (normalised) abscissas and weights at
+ *             t and `xm`, `wm` at -t:
+ *             - tanh-sinh: xp = xm = 1 - tanh(u), the distance from the
+ *               endpoints, to avoid cancellation;
+ *             - exp-sinh: xp = exp(u), xm = exp(-u);
+ *             - sinh-sinh: xp = sinh(u), xm = -sinh(u),
+ *             with u = pi/2 sinh(t).
+ */
+struct DoubleExpLevel {
+	std::vector<double> xp, wp, xm, wm;
+};
+
+/**
+ * @brief      Computes the nodes with t = k h, h = 2^-level, for k > 0 (odd k
+ *             when level > 0), until the weights or abscissas leave the range
+ *             of double.
+ */
+static DoubleExpLevel computeDoubleExpLevel(const DoubleExpMap &map,
+                                            const int &level) {
+	DoubleExpLevel nodes;
+	const double h    = ldexp(1.0, -level);
+	const int kStep   = level == 0 ? 1 : 2;
+	// exp(700) is well inside the range of double; for tanh-sinh the
+	// weights, ~exp(-2u), underflow already at u ~ 350
+	const double uMax = map == DoubleExpMap::tanhSinh ? 350.0 : 700.0;
+
+	for (int k = 1;; k += kStep) {
+		const double t = k * h;
+		const double u = M_PI_2 * sinh(t);
+		const double c = M_PI_2 * cosh(t);
+		if (u > uMax) break;
+
+		switch (map) {
+		case DoubleExpMap::tanhSinh: {
+			const double coshU = cosh(u);
+			const double frac  = exp(-u) / coshU;  // 1 - tanh(u)
+			const double w     = c / (coshU * coshU);
+			nodes.xp.push_back(frac);
+			nodes.wp.push_back(w);
+			nodes.xm.push_back(frac);
+			nodes.wm.push_back(w);
+			break;
+		}
+		case DoubleExpMap::expSinh:
+			nodes.xp.push_back(exp(u));
+			nodes.wp.push_back(c * exp(u));
+			nodes.xm.push_back(exp(-u));
+			nodes.wm.push_back(c * exp(-u));
+			break;
+		case DoubleExpMap::sinhSinh:
+			nodes.xp.push_back(sinh(u));
+			nodes.wp.push_back(c * cosh(u));
+			nodes.xm.push_back(-sinh(u));
+			nodes.wm.push_back(c * cosh(u));
+			break;
+		}
+	}
+
+	return nodes;
+}
+
+/**
+ * @brief      Gets the nodes of a level from the shared table, computing them
+ *             the first time.
+ */
+static const DoubleExpLevel &doubleExpLevel(const DoubleExpMap &map,
+                                            const int &level) {
+	static std::map<std::pair<DoubleExpMap, int>, DoubleExpLevel> cache;
+	static std::mutex cacheMutex;
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	const std::pair<DoubleExpMap, int> key(map, level);
+	auto it = cache.find(key);
+	if (it == cache.end())
+		it = cache.emplace(key, computeDoubleExpLevel(map, level)).first;
+	return it->second;
+}
+
+/**
+ * @brief      Double exponential quadrature with level by level refinement.
+ *             `a` and `b` are used only by the maps that need them.
+ */
+static double doubleExpQuad(double (*F)(const double &x),
+                            const DoubleExpMap &map, const double &a,
+                            const double &b, const double &tol, double &err,
+                            const int &maxLevel) {
+	if (maxLevel < 0)
+		throw std::invalid_argument("Invalid argument: maxLevel must be non "
+		                            "negative.");
+
+	const double half = 0.5 * (b - a);  // Used by tanh-sinh only
+
+	// Centre node, t = 0
+	double sum;
+	switch (map) {
+	case DoubleExpMap::tanhSinh:
+		sum = M_PI_2 * F(a + half);
+		break;
+	case DoubleExpMap::expSinh:
+		sum = M_PI_2 * F(a + 1.0);
+		break;
+	default:
+		sum = M_PI_2 * F(0.0);
+		break;
+	}
+
+	double integral = 0.0;
+	err             = 0.0;
+	for (int level = 0; level <= maxLevel; level++) {
+		const DoubleExpLevel &nodes = doubleExpLevel(map, level);
+		const int n                 = nodes.xp.size();
+
+		for (int k = 0; k < n; k++) {
+			switch (map) {
+			case DoubleExpMap::tanhSinh: {
+				// Skip the nodes that round to the endpoints
+				const double d = half * nodes.xp[k];
+				if (b - d != b) sum += nodes.wp[k] * F(b - d);
+				if (a + d != a) sum += nodes.wm[k] * F(a + d);
+				break;
+			}
+			case DoubleExpMap::expSinh:
+				sum += nodes.wp[k] * F(a + nodes.xp[k]);
+				if (a + nodes.xm[k] != a) sum += nodes.wm[k] * F(a + nodes.xm[k]);
+				break;
+			case DoubleExpMap::sinhSinh:
+				sum += nodes.wp[k] * F(nodes.xp[k]) + nodes.wm[k] * F(nodes.xm[k]);
+				break;
+			}
+		}
+
+		const double previous = integral;
+		integral              = ldexp(sum, -level);  // Trapezoidal rule in t
+		if (map == DoubleExpMap::tanhSinh) integral *= half;
+		if (level > 0) {
+			err = fabs(integral - previous);
+			if (err <= tol) break;
+		}
+	}
+
+	return integral;
+}
+
+double tanhSinhQuad(double (*F)(const double &x), const double &a,
+                    const double &b, const double &tol, double &err,
+                    const int &maxLevel) {
+	return doubleExpQuad(F, DoubleExpMap::tanhSinh, a, b, tol, err, maxLevel);
+}
+
+double tanhSinhQuad(double (*F)(const double &x), const double &a,
+                    const double &b, const double &tol) {
+	double err;
+	return tanhSinhQuad(F, a, b, tol, err);
+}
+
+double expSinhQuad(double (*F)(const double &x), const double &a,
+                   const double &tol, double &err, const int &maxLevel) {
+	return doubleExpQuad(F, DoubleExpMap::expSinh, a, a, tol, err, maxLevel);
+}
+
+double expSinhQuad(double (*F)(const double &x), const double &a,
+                   const double &tol) {
+	double err;
+	return expSinhQuad(F, a, tol, err);
+}
+
+double sinhSinhQuad(double (*F)(const double &x), const double &tol,
+                    double &err, const int &maxLevel) {
+	return doubleExpQuad(F, DoubleExpMap::sinhSinh, 0.0, 0.0, tol, err,
+	                     maxLevel);
+}
+
+double sinhSinhQuad(double (*F)(const double &x), const double &tol) {
+	double err;
+	return sinhSinhQuad(F, tol, err);
+}
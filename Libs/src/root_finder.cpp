@@ -1,64 +1,169 @@
 #include "../include/root_finder.hpp"
 
 #include "../include/debug.hpp"
+#include "../include/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief      Refines the brackets [xL[i], xR[i]] concurrently, with dynamic
+ *             scheduling since their cost can be very different.
+ */
+static void refineBrackets(double (*f)(const double &x),
+                           double (*dfdx)(const double &x),
+                           const double xL[], const double xR[],
+                           const int &nRoots, const double &tol,
+                           const RootMethod &method, double roots[],
+                           const int &nThreads) {
+	auto refine = [&](const int &i0, const int &i1) {
+		for (int i = i0; i < i1; i++) {
+			switch (method) {
+			case RootMethod::bisection:
+				bisection(f, xL[i], xR[i], tol, roots[i]);
+				break;
+			case RootMethod::falsePosition:
+				falsePosition(f, xL[i], xR[i], tol, roots[i]);
+				break;
+			case RootMethod::secant:
+				secant(f, xL[i], xR[i], tol, roots[i]);
+				break;
+			case RootMethod::newton:
+				newton(f, dfdx, xL[i], xR[i], tol, roots[i]);
+				break;
+			case RootMethod::brent:
+				brent(f, xL[i], xR[i], tol, roots[i]);
+				break;
+			case RootMethod::illinois:
+				illinois(f, xL[i], xR[i], tol, roots[i]);
+				break;
+			}
+
+#if DEBUG == TRUE
+			std::cout << "roots[" << i << "] = " << roots[i] << std::endl;
+#endif
+		}
+	};
+	parallelForDynamic(0, nRoots, refine, nThreads);
+}
+
+/**
+ * @brief      Halves [a, b], where f has the same sign at both ends, keeping
+ *             one half each time; appends the brackets found.
+ *
+ * Costs at most `maxDepth` evaluations of f.
+ */
+static void halveBracket(double (*f)(const double &x), double a, double fa,
+                         double b, double fb, const int &maxDepth,
+                         std::vector<std::pair<double, double>> &found) {
+	for (int depth = 0; depth < maxDepth; depth++) {
+		const double xm = 0.5 * (a + b);
+		const double fm = f(xm);
+		if (fm == 0.0) {
+			found.emplace_back(xm, b);
+			return;
+		} else if (fm * fa < 0) {  // Two sign changes
+			found.emplace_back(a, xm);
+			found.emplace_back(xm, b);
+			return;
+		}
+
+		// Keep the half towards the smaller end if |f| decreased at the
+		// midpoint, or else the half where f changes much faster than on a
+		// straight line
+		bool left;
+		if (fabs(fm) < std::min(fabs(fa), fabs(fb))) {
+			left = fabs(fa) < fabs(fb);
+		} else {
+			const double jump = fabs(fb - fa);
+			const double dL = fabs(fm - fa), dR = fabs(fb - fm);
+			if (std::max(dL, dR) <= 0.75 * jump) return;
+			left = dL >= dR;
+		}
+		if (left) {
+			b  = xm;
+			fb = fm;
+		} else {
+			a  = xm;
+			fa = fm;
+		}
+	}
+}
 
 int findRoots(double (*f)(const double &x), double (*dfdx)(const double &x),
               const double &xa, const double &xb, const double &tol,
               double roots[], int &nRoots, const int N,
-              const std::string method) {
-	if (N > 128) throw std::invalid_argument("N must be less than 128");
+              const std::string method, const int nThreads) {
+	return findRoots(f, dfdx, xa, xb, tol, roots, nRoots, N,
+	                 rootMethod(method), nThreads);
+}
 
-	double xL[128], xR[128];
+int findRoots(double (*f)(const double &x), const double &xa, const double &xb,
+              const double &tol, double roots[], int &nRoots, const int N,
+              const std::string method, const int nThreads) {
+	if (method == "newton")
+		throw std::invalid_argument(
+			"Newton method isn't available with this prototype.");
 
-	bracket(f, xa, xb, xL, xR, N, nRoots);
+	return findRoots(f, nullptr, xa, xb, tol, roots, nRoots, N,
+	                 rootMethod(method), nThreads);
+}
+
+int findRoots(double (*f)(const double &x), double (*dfdx)(const double &x),
+              const double &xa, const double &xb, const double &tol,
+              double roots[], int &nRoots, const int N,
+              const RootMethod method, const int nThreads) {
+	if (N <= 0) throw std::invalid_argument("N must be positive");
+	if (method == RootMethod::newton && dfdx == nullptr)
+		throw std::invalid_argument(
+			"Newton method isn't available with this prototype.");
+
+	std::vector<double> xL(N), xR(N);
+
+	bracket(f, xa, xb, xL.data(), xR.data(), N, nRoots, nThreads);
 
 	if (nRoots == 0) {
 		throw std::runtime_error(
 			"The supplied interval does not contain any roots.");
 	}
 
-	for (int i = 0; i < nRoots; i++) {
-		if (method == "bisection") bisection(f, xL[i], xR[i], tol, roots[i]);
-		else if (method == "falsePosition")
-			falsePosition(f, xL[i], xR[i], tol, roots[i]);
-		else if (method == "secant") secant(f, xL[i], xR[i], tol, roots[i]);
-		else if (method == "newton")
-			newton(f, dfdx, xL[i], xR[i], tol, roots[i]);
-		else throw std::invalid_argument("Invalid method argument.");
+	refineBrackets(f, dfdx, xL.data(), xR.data(), nRoots, tol, method, roots,
+	               nThreads);
 
-#if DEBUG == TRUE
-		std::cout << "roots[" << i << "] = " << roots[i] << std::endl;
-#endif
-	}
-
-	// std::cout << "Method used: " << method << std::endl;
 	return 0;
 }
 
 int findRoots(double (*f)(const double &x), const double &xa, const double &xb,
               const double &tol, double roots[], int &nRoots, const int N,
-              const std::string method) {
-	if (method == "newton")
-		throw std::invalid_argument(
-			"Newton method isn't available with this prototype.");
-
-	return findRoots(f, nullptr, xa, xb, tol, roots, nRoots, N, method);
+              const RootMethod method, const int nThreads) {
+	return findRoots(f, nullptr, xa, xb, tol, roots, nRoots, N, method,
+	                 nThreads);
 }
 
 void bracket(double (*f)(const double &x), const double &xa, const double &xb,
-             double xL[], double xR[], const int &N, int &nRoots) {
-	double dx          = (xb - xa) / N;
-	double xi          = xa;
-	double xi_plus_one = xi + dx;
-	int root_counter   = 0;
+             double xL[], double xR[], const int &N, int &nRoots,
+             const int nThreads) {
+	double dx        = (xb - xa) / N;
+	int root_counter = 0;
+
+	// Grid points, evaluated concurrently
+	std::vector<double> x(N + 1), fx(N + 1);
+	x[0] = xa;
+	for (int i = 0; i < N; i++) x[i + 1] = x[i] + dx;
+	parallelFor(
+		0, N + 1,
+		[&](const int &i0, const int &i1) {
+			for (int i = i0; i < i1; i++) fx[i] = f(x[i]);
+		},
+		nThreads);
 
-	double fL = f(xi), fR;
 	for (int i = 0; i < N; i++) {
-		fR = f(xi_plus_one);
-		if (fL == 0.0 ||
-		    fL * fR < 0) {  // Check if there's a root in [xi, xi_plus_one)
-			xL[root_counter] = xi;
-			xR[root_counter] = xi_plus_one;
+		if (fx[i] == 0.0 ||
+		    fx[i] * fx[i + 1] < 0) {  // Check if there's a root in [x_i, x_i+1)
+			xL[root_counter] = x[i];
+			xR[root_counter] = x[i + 1];
 
 #if DEBUG == TRUE
 			std::cout << "found root in [a, b) = [" << xL[root_counter] << ", "
@@ -67,16 +172,108 @@ void bracket(double (*f)(const double &x), const double &xa, const double &xb,
 
 			root_counter++;
 		}
-
-		// Shift interval
-		fL = fR;
-		xi = xi_plus_one;
-		xi_plus_one += dx;
 	}
 
 	nRoots = root_counter;
 }
 
+std::vector<double> findRoots(double (*f)(const double &x),
+                              double (*dfdx)(const double &x),
+                              const double &xa, const double &xb,
+                              const double &tol, const int N,
+                              const RootMethod method, const int maxDepth,
+                              const int nThreads) {
+	if (method == RootMethod::newton && dfdx == nullptr)
+		throw std::invalid_argument(
+			"Newton method isn't available with this prototype.");
+
+	std::vector<double> xL, xR;
+	bracketAdaptive(f, xa, xb, xL, xR, N, maxDepth, nThreads);
+
+	const int nRoots = static_cast<int>(xL.size());
+	std::vector<double> roots(nRoots);
+	refineBrackets(f, dfdx, xL.data(), xR.data(), nRoots, tol, method,
+	               roots.data(), nThreads);
+	return roots;
+}
+
+std::vector<double> findRoots(double (*f)(const double &x),
+                              const double &xa, const double &xb,
+                              const double &tol, const int N,
+                              const RootMethod method, const int maxDepth,
+                              const int nThreads) {
+	return findRoots(f, nullptr, xa, xb, tol, N, method, maxDepth, nThreads);
+}
+
+void bracketAdaptive(double (*f)(const double &x),
+                     const double &xa, const double &xb,
+                     std::vector<double> &xL, std::vector<double> &xR,
+                     const int &N, const int &maxDepth, const int nThreads) {
+	if (N <= 0) throw std::invalid_argument("N must be positive");
+
+	// Uniform grid, evaluated concurrently
+	const double dx = (xb - xa) / N;
+	std::vector<double> x(N + 1), fx(N + 1);
+	x[0] = xa;
+	for (int i = 0; i < N; i++) x[i + 1] = x[i] + dx;
+	parallelFor(
+		0, N + 1,
+		[&](const int &i0, const int &i1) {
+			for (int i = i0; i < i1; i++) fx[i] = f(x[i]);
+		},
+		nThreads);
+
+	// Sign changes, and sub-intervals next to a local minimum of |f|, or where
+	// the first or second difference of f is far above its mean on the grid
+	auto localMin = [&](const int &i) {
+		return (i == 0 || fabs(fx[i]) <= fabs(fx[i - 1])) &&
+		       (i == N || fabs(fx[i]) <= fabs(fx[i + 1]));
+	};
+	auto diff1 = [&](const int &i) { return fabs(fx[i + 1] - fx[i]); };
+	auto diff2 = [&](const int &i) {
+		return (i == 0 || i == N) ? 0.0
+		                          : fabs(fx[i - 1] - 2 * fx[i] + fx[i + 1]);
+	};
+	double mean1 = 0, mean2 = 0;
+	for (int i = 0; i < N; i++) {
+		if (std::isfinite(diff1(i))) mean1 += diff1(i) / N;
+		if (std::isfinite(diff2(i))) mean2 += diff2(i) / N;
+	}
+	auto rapid = [&](const int &i) {
+		return diff1(i) > 4 * mean1 || diff2(i) > 4 * mean2 ||
+		       diff2(i + 1) > 4 * mean2;
+	};
+	std::vector<std::vector<std::pair<double, double>>> found(N);
+	std::vector<int> suspicious;
+	for (int i = 0; i < N; i++) {
+		if (fx[i] == 0.0 || fx[i] * fx[i + 1] < 0)
+			found[i].emplace_back(x[i], x[i + 1]);
+		else if (maxDepth > 0 && (localMin(i) || localMin(i + 1) || rapid(i)))
+			suspicious.push_back(i);
+	}
+
+	// Refine the suspicious sub-intervals concurrently
+	parallelForDynamic(
+		0, static_cast<int>(suspicious.size()),
+		[&](const int &j0, const int &j1) {
+			for (int j = j0; j < j1; j++) {
+				const int i = suspicious[j];
+				halveBracket(f, x[i], fx[i], x[i + 1], fx[i + 1], maxDepth,
+				             found[i]);
+			}
+		},
+		nThreads);
+
+	xL.clear();
+	xR.clear();
+	for (const std::vector<std::pair<double, double>> &brackets : found) {
+		for (const std::pair<double, double> &br : brackets) {
+			xL.push_back(br.first);
+			xR.push_back(br.second);
+		}
+	}
+}
+
 // =====================================================================================================================
 // Bisection method
 // =====================================================================================================================
@@ -257,6 +454,213 @@ int falsePosition(double (*f)(const double &x), double xa, double xb,
 	return falsePosition(f, xa, xb, xtol, ftol, root, n);
 }
 
+// =====================================================================================================================
+// Brent's method
+// =====================================================================================================================
+
+int brent(double (*f)(const double &x), double xa, double xb,
+          const double &xtol, const double &ftol, double &root, int &ntry) {
+	int max_ntry = 128;
+	double fa    = f(xa);
+	double fb    = f(xb);
+
+	// Handle fa, fb = 0
+	if (fa == 0.0) {
+		ntry = 0;
+		root = xa;
+		return 0;
+	} else if (fb == 0.0) {
+		ntry = 0;
+		root = xb;
+		return 0;
+	}
+
+	if (fa * fb < 0) {  // Necessary condition
+		// b is the best estimate, [b, c] brackets the root, a is the previous b
+		double xc = xa, fc = fa;
+		double d = xb - xa, e = d;
+		for (int k = 0; k <= max_ntry; k++) {
+			// Keep the root bracketed by [b, c]
+			if ((fb > 0.0) == (fc > 0.0)) {
+				xc = xa;
+				fc = fa;
+				d  = xb - xa;
+				e  = d;
+			}
+			if (fabs(fc) < fabs(fb)) {
+				xa = xb;
+				xb = xc;
+				xc = xa;
+				fa = fb;
+				fb = fc;
+				fc = fa;
+			}
+
+			const double tol1 = 2.0 * 2.2e-16 * fabs(xb) + 0.5 * xtol;
+			const double xm   = 0.5 * (xc - xb);
+
+#if DEBUG == TRUE
+			std::cout.setf(std::ios::scientific | std::ios::showpos);
+			std::cout << "brent(): k = " << std::setw(log10(max_ntry) + 1) << k
+					  << "; [b, c] = [" << xb << ", " << xc << "]; fb = " << fb
+					  << std::endl;
+			std::cout << std::resetiosflags(std::ios::scientific |
+			                                std::ios::showpos);
+#endif
+
+			// Check convergence
+			if (fabs(xm) <= tol1 || fabs(fb) < ftol || fb == 0.0) {
+				ntry = k;
+				root = xb;
+				return 0;
+			}
+			if (k == max_ntry) break;
+
+			if (fabs(e) >= tol1 && fabs(fa) > fabs(fb)) {
+				// Inverse quadratic interpolation (secant if a == c)
+				double p, q, s = fb / fa;
+				if (xa == xc) {
+					p = 2.0 * xm * s;
+					q = 1.0 - s;
+				} else {
+					const double r = fb / fc;
+					q              = fa / fc;
+					p = s * (2.0 * xm * q * (q - r) - (xb - xa) * (r - 1.0));
+					q = (q - 1.0) * (r - 1.0) * (s - 1.0);
+				}
+				if (p > 0.0) q = -q;
+				p = fabs(p);
+
+				// Accept the interpolation only if it falls well inside
+				if (2.0 * p < std::min(3.0 * xm * q - fabs(tol1 * q), fabs(e * q))) {
+					e = d;
+					d = p / q;
+				} else {
+					d = xm;
+					e = d;
+				}
+			} else {  // Bisection
+				d = xm;
+				e = d;
+			}
+
+			xa = xb;
+			fa = fb;
+			xb += (fabs(d) > tol1) ? d : (xm > 0.0 ? tol1 : -tol1);
+			fb = f(xb);
+		}
+
+		ntry = -1;
+		root = nan("");
+		throw std::runtime_error("Maximum number of steps exceeded.");
+	}
+
+	throw std::runtime_error(
+		"The supplied interval does not contain any roots.");
+}
+
+int brent(double (*f)(const double &x), double xa, double xb,
+          const double &xtol, double &root) {
+	int n;
+	return brent(f, xa, xb, xtol, -1.0, root, n);
+}
+
+int brent(double (*f)(const double &x), double xa, double xb,
+          const double &xtol, double &root, int &ntry) {
+	return brent(f, xa, xb, xtol, -1.0, root, ntry);
+}
+
+int brent(double (*f)(const double &x), double xa, double xb,
+          const double &xtol, const double &ftol, double &root) {
+	int n;
+	return brent(f, xa, xb, xtol, ftol, root, n);
+}
+
+// =====================================================================================================================
+// Illinois method
+// =====================================================================================================================
+
+int illinois(double (*f)(const double &x), double xa, double xb,
+             const double &xtol, const double &ftol, double &root, int &ntry) {
+	int max_ntry = 128;
+	double fa    = f(xa);
+	double fb    = f(xb);
+	double xm, fm;
+	int side = 0;  // The end that was kept in the last iteration
+
+	// Handle fa, fb = 0
+	if (fa == 0.0) {
+		ntry = 0;
+		root = xa;
+		return 0;
+	} else if (fb == 0.0) {
+		ntry = 0;
+		root = xb;
+		return 0;
+	}
+
+	if (fa * fb < 0) {  // Necessary condition
+		for (int k = 1; k <= max_ntry; k++) {
+			// Linear intersection
+			xm = (xa * fb - xb * fa) / (fb - fa);
+			fm = f(xm);
+
+#if DEBUG == TRUE
+			std::cout.setf(std::ios::scientific | std::ios::showpos);
+			std::cout << "illinois(): k = " << std::setw(log10(max_ntry) + 1)
+					  << k << "; [a, b] = [" << xa << ", " << xb
+					  << "]; xm = " << xm << "; fm = " << fm << std::endl;
+			std::cout << std::resetiosflags(std::ios::scientific |
+			                                std::ios::showpos);
+#endif
+
+			// Redefine interval, halving the value at a retained end
+			if (fm * fb > 0) {
+				xb = xm;
+				fb = fm;
+				if (side == -1) fa *= 0.5;
+				side = -1;
+			} else {
+				xa = xm;
+				fa = fm;
+				if (side == 1) fb *= 0.5;
+				side = 1;
+			}
+
+			// Check convergence
+			if (fabs(xb - xa) < xtol || fabs(fm) < ftol || fm == 0.0) {
+				ntry = k;
+				root = xm;
+				return 0;
+			}
+		}
+
+		ntry = -1;
+		root = nan("");
+		throw std::runtime_error("Maximum number of steps exceeded.");
+	}
+
+	throw std::runtime_error(
+		"The supplied interval does not contain any roots.");
+}
+
+int illinois(double (*f)(const double &x), double xa, double xb,
+             const double &xtol, double &root) {
+	int n;
+	return illinois(f, xa, xb, xtol, -1.0, root, n);
+}
+
+int illinois(double (*f)(const double &x), double xa, double xb,
+             const double &xtol, double &root, int &ntry) {
+	return illinois(f, xa, xb, xtol, -1.0, root, ntry);
+}
+
+int illinois(double (*f)(const double &x), double xa, double xb,
+             const double &xtol, const double &ftol, double &root) {
+	int n;
+	return illinois(f, xa, xb, xtol, ftol, root, n);
+}
+
 // =====================================================================================================================
 // Secant method
 // =====================================================================================================================
@@ -208,6 +208,126 @@ TEST_CASE("testing solveLinSystem function") {
 	delete[] M;
 }
 
+TEST_CASE("testing luDecomposition and luSolve functions") {
+	SUBCASE("4x4 matrix") {
+		const int N = 4;
+		double A[N * N] = {1, 2, 1, -1,
+		                   3, 2, 4,  4,
+		                   4, 4, 3,  4,
+		                   2, 0, 1,  5};
+		double v[] = {5, 16, 22, 15};
+		double x[N];
+		int piv[N];
+
+		double solution[] = {16, -6, -2, -3};
+
+		luDecomposition(A, piv, N);
+		luSolve(A, piv, v, x, N);
+
+		CHECK(piv[0] == 2);
+		for (int i = 0; i < N; i++) {
+			CHECK(x[i] == doctest::Approx(solution[i]));
+		}
+	}
+
+	SUBCASE("matrix larger than one block") {
+		const int N = 150;
+		std::vector<double> A(N * N), LU(N * N);
+		std::vector<double> x(N), v(N, 0.0);
+		std::vector<int> piv(N);
+
+		for (int i = 0; i < N; i++) {
+			for (int j = 0; j < N; j++) {
+				A[i * N + j] = sin(0.37 * i + 1.3 * j * j) + (i == j ? 2.0 : 0.0);
+			}
+		}
+		for (int i = 0; i < N; i++) {
+			for (int j = 0; j < N; j++) v[i] += A[i * N + j] * (j % 7 - 3.0);
+		}
+
+		LU = A;
+		luDecomposition(LU.data(), piv.data(), N, 16);
+		luSolve(LU.data(), piv.data(), v.data(), x.data(), N);
+
+		for (int i = 0; i < N; i++) {
+			CHECK(x[i] == doctest::Approx(i % 7 - 3.0));
+		}
+	}
+
+	SUBCASE("singular matrix") {
+		double A[] = {1, 2,
+		              2, 4};
+		int piv[2];
+		CHECK_THROWS_WITH_AS(luDecomposition(A, piv, 2),
+		                     "Matrix is singular.",
+		                     std::runtime_error);
+	}
+}
+
+TEST_CASE("testing LUFactorization class") {
+	const int N = 4;
+	const double A[N * N] = {1, 2, 1, -1,
+	                         3, 2, 4,  4,
+	                         4, 4, 3,  4,
+	                         2, 0, 1,  5};
+	LUFactorization<double> lu(A, N);
+
+	SUBCASE("single right-hand side") {
+		double v[] = {5, 16, 22, 15};
+		double x[N];
+		double solution[] = {16, -6, -2, -3};
+
+		lu.solve(v, x);
+		for (int i = 0; i < N; i++) {
+			CHECK(x[i] == doctest::Approx(solution[i]));
+		}
+
+		// Solve in place, factors are reused
+		lu.solve(v, v);
+		for (int i = 0; i < N; i++) {
+			CHECK(v[i] == doctest::Approx(solution[i]));
+		}
+	}
+
+	SUBCASE("many right-hand sides") {
+		// Columns: {5, 16, 22, 15} and the first column of A
+		double V[N * 2] = {5,  1,
+		                   16, 3,
+		                   22, 4,
+		                   15, 2};
+		double X[N * 2];
+		double solution[N * 2] = {16, 1,
+		                          -6, 0,
+		                          -2, 0,
+		                          -3, 0};
+
+		lu.solve(V, X, 2);
+		for (int i = 0; i < N * 2; i++) {
+			CHECK(X[i] == doctest::Approx(solution[i]));
+		}
+	}
+
+	SUBCASE("row-pointer constructor") {
+		double **M = new double *[N];
+		M[0]       = new double[N * N];
+		for (int i = 1; i < N; i++) M[i] = M[i - 1] + N;
+		for (int i = 0; i < N * N; i++) M[0][i] = A[i];
+
+		LUFactorization<double> luM(M, N);
+		double v[] = {5, 16, 22, 15};
+		double solution[] = {16, -6, -2, -3};
+
+		luM.solve(v, v);
+		CHECK(luM.size() == N);
+		for (int i = 0; i < N; i++) {
+			CHECK(v[i] == doctest::Approx(solution[i]));
+		}
+
+		delete[] M[0];
+		delete[] M;
+	}
+}
+
 TEST_CASE("testing tridiagonalSolver function") {
 	const int nEq = 5;
 	double a[nEq] = {nan(""), 1, 1, 1, 1};
@@ -225,11 +345,32 @@ TEST_CASE("testing tridiagonalSolver function") {
 		}
 	}
 
-	SUBCASE("exceptions") {
-		CHECK_THROWS_WITH_AS(tridiagonalSolver(a, b, c, v, x, 5000),
-							 "Number of equations must not be greater than 4096.",
-							 std::invalid_argument);
+	SUBCASE("in place") {
+		double expected[nEq] = {2, -3, 4, -2, 1};
+		tridiagonalSolverInPlace(a, b, c, v, nEq);
 
+		for (int i = 0; i < nEq; i++) {
+			CHECK(v[i] == doctest::Approx(expected[i]));
+		}
+	}
+
+	SUBCASE("more than 4096 equations") {
+		const int n = 10000;
+		std::vector<double> A(n, -1.0), B(n, 4.0), C(n, -1.0), R(n), X(n);
+		A[0]     = nan("");
+		C[n - 1] = nan("");
+		for (int i = 0; i < n; i++) {
+			// Exact solution: x_i = 1
+			R[i] = 2.0 + (i == 0 || i == n - 1 ? 1.0 : 0.0);
+		}
+
+		tridiagonalSolver(A.data(), B.data(), C.data(), R.data(), X.data(), n);
+		for (int i = 0; i < n; i += 999) {
+			CHECK(X[i] == doctest::Approx(1.0));
+		}
+	}
+
+	SUBCASE("exceptions") {
 		double A[] = {0, 1, 1, 1, 1};
 		CHECK_THROWS_WITH_AS(tridiagonalSolver(A, b, c, v, x, nEq),
 							 "The first element of a must be nan(\"\").",
@@ -241,3 +382,90 @@ TEST_CASE("testing tridiagonalSolver function") {
 							 std::invalid_argument);
 	}
 }
+
+TEST_CASE("testing tridiagonalSolverBatch function") {
+	const int nEq = 50, nSys = 37;
+	std::vector<double> a(nEq * nSys), b(nEq * nSys), c(nEq * nSys);
+	std::vector<double> r(nEq * nSys), x(nEq * nSys);
+
+	// System s has diagonal 2 + s and random-ish off-diagonals
+	for (int i = 0; i < nEq; i++) {
+		for (int s = 0; s < nSys; s++) {
+			a[i * nSys + s] = (i == 0) ? nan("") : sin(i + s);
+			b[i * nSys + s] = 2.0 + s;
+			c[i * nSys + s] = (i == nEq - 1) ? nan("") : cos(i * s);
+			r[i * nSys + s] = i - 0.5 * s;
+		}
+	}
+
+	SUBCASE("same solution as tridiagonalSolver") {
+		for (int nThreads : {1, 3}) {
+			tridiagonalSolverBatch(a.data(), b.data(), c.data(), r.data(),
+			                       x.data(), nEq, nSys, nThreads);
+
+			for (int s = 0; s < nSys; s++) {
+				double A[nEq], B[nEq], C[nEq], R[nEq], X[nEq];
+				for (int i = 0; i < nEq; i++) {
+					A[i] = a[i * nSys + s];
+					B[i] = b[i * nSys + s];
+					C[i] = c[i * nSys + s];
+					R[i] = r[i * nSys + s];
+				}
+				tridiagonalSolver(A, B, C, R, X, nEq);
+				for (int i = 0; i < nEq; i++) {
+					CHECK(x[i * nSys + s] == doctest::Approx(X[i]));
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("testing tridiagonalSolverParallel function") {
+	const int nEq = 1001;
+	std::vector<double> a(nEq), b(nEq), c(nEq), r(nEq), x(nEq), expected(nEq);
+	for (int i = 0; i < nEq; i++) {
+		a[i] = (i == 0) ? nan("") : 1.0 + 0.5 * sin(i);
+		b[i] = -4.0 + cos(3.0 * i);
+		c[i] = (i == nEq - 1) ? nan("") : 1.0 - 0.3 * cos(i);
+		r[i] = sin(0.01 * i) + 0.1 * i;
+	}
+	tridiagonalSolver(a.data(), b.data(), c.data(), r.data(), expected.data(),
+	                  nEq);
+
+	SUBCASE("partitioned on many threads") {
+		for (int nThreads : {2, 3, 8}) {
+			tridiagonalSolverParallel(a.data(), b.data(), c.data(), r.data(),
+			                          x.data(), nEq, nThreads, 0);
+			for (int i = 0; i < nEq; i++) {
+				CHECK(x[i] == doctest::Approx(expected[i]));
+			}
+		}
+	}
+
+	SUBCASE("fallback to Thomas below the threshold") {
+		tridiagonalSolverParallel(a.data(), b.data(), c.data(), r.data(),
+		                          x.data(), nEq, 4);
+		for (int i = 0; i < nEq; i++) CHECK(x[i] == expected[i]);
+	}
+}
+
+double bvpRHS(const double& x) {
+	return 2.0;
+}
+
+TEST_CASE("testing linearBVP function") {
+	// y'' = 2, y(0) = 0, y(1) = 1  =>  y = x^2 (exact for central differences)
+	const int nPoints = 10001;
+	std::vector<double> y(nPoints);
+
+	linearBVP(bvpRHS, y.data(), 0.0, 1.0, 0.0, 1.0, nPoints);
+
+	const double dx = 1.0 / (nPoints - 1);
+	for (int i = 0; i < nPoints; i += 1000) {
+		CHECK(y[i] == doctest::Approx(i * dx * i * dx).epsilon(1e-8));
+	}
+
+	CHECK_THROWS_WITH_AS(linearBVP(bvpRHS, y.data(), 0.0, 1.0, 0.0, 1.0, 2),
+	                     "Number of points must be at least 3.",
+	                     std::invalid_argument);
+}
@@ -1,4 +1,5 @@
 #include <cmath>
+#include <vector>
 
 #include "test_config.hpp"
 #include "../include/ode_solver.hpp"
@@ -7,10 +8,353 @@ void RHS1(const double& t, double Y[], double R[]);
 
 double exact1(const double& t);
 
+void RHSMany(const double& t, double Y[], double R[]);
+
+void RHSOsc(double Y[], double R[]);
+
 TEST_CASE("testing eulerStep function") {
 	
 }
 
+TEST_CASE("testing rk4Step function") {
+	SUBCASE("single equation") {
+		double Y[] = {1.0};
+		double t = 0.0;
+		const double dt = 0.01;
+		for (int i = 0; i < 100; i++) {
+			rk4Step(t, Y, RHS1, dt, 1);
+			t += dt;
+		}
+		CHECK(Y[0] == doctest::Approx(exact1(t)).epsilon(1e-9));
+	}
+
+	SUBCASE("more than 64 equations") {
+		const int neq = 1000;
+		std::vector<double> Y(neq, 1.0);
+		CHECK_NOTHROW(rk4Step(0.0, Y.data(), RHSMany, 0.1, neq));
+		for (int i = 0; i < neq; i++) {
+			CHECK(Y[i] == doctest::Approx(exp(-0.1 * (i % 3))).epsilon(1e-5));
+		}
+	}
+
+	SUBCASE("nested step inside the Right Hand Side") {
+		// The inner step has more equations than the outer one, so it
+		// must not reuse (and reallocate) the scratch of the outer step
+		int innerSteps = 0;
+		auto rhs = [&innerSteps](const double& t, double Y[], double R[]) {
+			std::vector<double> Z(1000, 1.0);
+			rk4Step(t, Z.data(), RHSMany, 0.1, 1000);
+			innerSteps++;
+			RHS1(t, Y, R);
+		};
+
+		double Y[] = {1.0}, Yref[] = {1.0};
+		double t = 0.0;
+		const double dt = 0.01;
+		for (int i = 0; i < 100; i++) {
+			rk4Step(t, Y, rhs, dt, 1);
+			rk4Step(t, Yref, RHS1, dt, 1);
+			t += dt;
+		}
+		CHECK(innerSteps == 400);
+		CHECK(Y[0] == Yref[0]);
+	}
+}
+
+TEST_CASE("testing step functions with callables") {
+	SUBCASE("lambda with captured parameter") {
+		// dy/dt = -k y
+		const double k = 0.7;
+		auto rhs = [k](const double& t, double Y[], double R[]) { R[0] = -k * Y[0]; };
+
+		double Y[] = {1.0};
+		const double dt = 0.01;
+		for (int i = 0; i < 100; i++) rk4Step(i * dt, Y, rhs, dt, 1);
+		CHECK(Y[0] == doctest::Approx(exp(-k)).epsilon(1e-9));
+
+		Y[0] = 1.0;
+		for (int i = 0; i < 100; i++) rk2Step(i * dt, Y, rhs, dt, 1, true);
+		CHECK(Y[0] == doctest::Approx(exp(-k)).epsilon(1e-5));
+	}
+
+	SUBCASE("functor gives the same result as function pointer") {
+		struct Decay {
+			void operator()(const double& t, double Y[], double R[]) const { RHS1(t, Y, R); }
+		};
+
+		double Y1[] = {1.0}, Y2[] = {1.0};
+		for (int i = 0; i < 10; i++) {
+			eulerStep(0.1 * i, Y1, RHS1, 0.1, 1);
+			eulerStep(0.1 * i, Y2, Decay(), 0.1, 1);
+		}
+		CHECK(Y1[0] == Y2[0]);
+	}
+
+	SUBCASE("lambda for position Verlet") {
+		// x'' = -w^2 x
+		const double w = 2.0;
+		auto acc = [w](double Y[], double R[]) {
+			R[0] = Y[1];
+			R[1] = -w * w * Y[0];
+		};
+
+		double Y[] = {1.0, 0.0};
+		const double dt = 1.0e-3;
+		for (int i = 0; i < 1000; i++) pVerlet(i * dt, Y, acc, dt, 2);
+		CHECK(Y[0] == doctest::Approx(cos(w)).epsilon(1e-5));
+	}
+}
+
+TEST_CASE("testing ODEStepper class") {
+	const int neq = 1000;
+	ODEStepper stepper(neq);
+	CHECK(stepper.size() == neq);
+
+	SUBCASE("rk4 matches rk4Step") {
+		std::vector<double> Y1(neq, 1.0), Y2(neq, 1.0);
+		for (int k = 0; k < 10; k++) {
+			stepper.rk4(0.1 * k, Y1.data(), RHSMany, 0.1);
+			rk4Step(0.1 * k, Y2.data(), RHSMany, 0.1, neq);
+		}
+		for (int i = 0; i < neq; i++) CHECK(Y1[i] == Y2[i]);
+	}
+
+	SUBCASE("velocity Verlet on harmonic oscillators") {
+		// x'' = -x, x(0) = 1, v(0) = 0 for neq / 2 particles
+		std::vector<double> Y(neq, 0.0);
+		for (int i = 0; i < neq / 2; i++) Y[i] = 1.0;
+
+		const double dt = 1.0e-3;
+		for (int k = 0; k < 1000; k++) stepper.vVerlet(k * dt, Y.data(), RHSOsc, dt);
+		for (int i = 0; i < neq / 2; i++) {
+			CHECK(Y[i] == doctest::Approx(cos(1.0)).epsilon(1e-6));
+			CHECK(Y[i + neq / 2] == doctest::Approx(-sin(1.0)).epsilon(1e-6));
+		}
+	}
+
+	SUBCASE("odd number of equations") {
+		std::vector<double> Y(neq, 0.0);
+		stepper.resize(3);
+		CHECK_THROWS_AS(stepper.pVerlet(0.0, Y.data(), RHSOsc, 0.1), std::invalid_argument);
+	}
+}
+
+TEST_CASE("testing DormandPrince class") {
+	SUBCASE("gaussian decay") {
+		DormandPrince dopri(1, 1.0e-10, 1.0e-10);
+		double Y[] = {1.0};
+		double t = 0.0;
+
+		dopri.integrate(RHS1, t, Y, 3.0);
+		CHECK(t == 3.0);
+		CHECK(Y[0] == doctest::Approx(exact1(3.0)).epsilon(1e-8));
+	}
+
+	SUBCASE("harmonic oscillator, forward and backward") {
+		auto rhs = [](const double& t, double Y[], double R[]) {
+			R[0] = Y[1];
+			R[1] = -Y[0];
+		};
+		DormandPrince dopri(2, 1.0e-10, 1.0e-10);
+		double Y[] = {1.0, 0.0};
+		double t = 0.0;
+
+		const int nSteps = dopri.integrate(rhs, t, Y, 20.0);
+		CHECK(Y[0] == doctest::Approx(cos(20.0)).epsilon(1e-7));
+		CHECK(Y[1] == doctest::Approx(-sin(20.0)).epsilon(1e-7));
+
+		// FSAL: 6 evaluations per step, plus the start-up ones
+		CHECK(dopri.nAccepted() == nSteps);
+		CHECK(dopri.nEval() <= 6 * (dopri.nAccepted() + dopri.nRejected()) + 2);
+
+		dopri.integrate(rhs, t, Y, 0.0);
+		CHECK(t == 0.0);
+		CHECK(Y[0] == doctest::Approx(1.0).epsilon(1e-7));
+		CHECK(Y[1] == doctest::Approx(0.0).epsilon(1e-7));
+	}
+
+	SUBCASE("looser tolerance needs fewer evaluations") {
+		double Y[] = {1.0};
+		double t = 0.0;
+		DormandPrince tight(1, 1.0e-12, 1.0e-12), loose(1, 1.0e-6, 1.0e-6);
+
+		tight.integrate(RHS1, t, Y, 3.0);
+		t = 0.0;
+		Y[0] = 1.0;
+		loose.integrate(RHS1, t, Y, 3.0);
+
+		CHECK(loose.nEval() < tight.nEval());
+		CHECK(Y[0] == doctest::Approx(exact1(3.0)).epsilon(1e-5));
+	}
+
+	SUBCASE("step size too small at t = 0") {
+		// Undefined for t > 0: every step is rejected until the step size is
+		// negligible against tEnd, not until it underflows to zero
+		auto rhs = [](const double& t, double Y[], double R[]) { R[0] = sqrt(-t); };
+		DormandPrince dopri(1);
+		double Y[] = {1.0};
+		double t = 0.0;
+
+		CHECK_THROWS_WITH_AS(dopri.integrate(rhs, t, Y, 1.0), "Step size too small.", std::runtime_error);
+		CHECK(t == 0.0);
+		CHECK(dopri.nRejected() < 30);
+	}
+}
+
+TEST_CASE("testing DormandPrince dense output") {
+	auto rhs = [](const double& t, double Y[], double R[]) {
+		R[0] = Y[1];
+		R[1] = -Y[0];
+	};
+	DormandPrince dopri(2, 1.0e-10, 1.0e-10);
+	double Y[] = {1.0, 0.0};
+	double t = 0.0;
+	double Yi[2];
+
+	CHECK_THROWS_WITH(dopri.denseOutput(0.0, Yi), "No step has been taken yet.");
+
+	SUBCASE("inside every step") {
+		dopri.start(rhs, t, Y, 10.0);
+		while (t < 10.0) {
+			dopri.step(rhs, t, Y, 10.0);
+			CHECK(dopri.stepEnd() == t);
+
+			const double t0 = dopri.stepStart(), t1 = dopri.stepEnd();
+			for (int j = 0; j <= 4; j++) {
+				const double ti = t0 + 0.25 * j * (t1 - t0);
+				dopri.denseOutput(ti, Yi);
+				CHECK(Yi[0] == doctest::Approx(cos(ti)).epsilon(1e-7));
+				CHECK(dopri.denseOutput(ti, 1) == doctest::Approx(-sin(ti)).epsilon(1e-7));
+			}
+		}
+
+		// The interpolant is exact at the end points
+		dopri.denseOutput(t, Yi);
+		CHECK(Yi[0] == doctest::Approx(Y[0]).epsilon(1e-14));
+		CHECK(Yi[1] == doctest::Approx(Y[1]).epsilon(1e-14));
+	}
+
+	SUBCASE("outside the last step") {
+		dopri.start(rhs, t, Y, 10.0);
+		dopri.step(rhs, t, Y, 10.0);
+		CHECK_THROWS_WITH(dopri.denseOutput(t + 1.0, Yi), "t must be inside the last step.");
+		CHECK_THROWS_WITH(dopri.denseOutput(-1.0, Yi), "t must be inside the last step.");
+	}
+}
+
+TEST_CASE("testing DormandPrince events") {
+	auto rhs = [](const double& t, double Y[], double R[]) {
+		R[0] = Y[1];
+		R[1] = -Y[0];
+	};
+	auto position = [](const double& t, const double Y[]) { return Y[0]; };
+	DormandPrince dopri(2, 1.0e-10, 1.0e-10);
+	double Y[] = {1.0, 0.0};
+	double t = 0.0;
+
+	SUBCASE("counting events") {
+		const int any     = dopri.addEvent(position);
+		const int falling = dopri.addEvent(position, -1);
+		dopri.integrate(rhs, t, Y, 10.0);
+
+		CHECK(t == 10.0);
+		CHECK_FALSE(dopri.stopped());
+		CHECK(dopri.eventCount(any) == 3);
+		CHECK(dopri.eventCount(falling) == 2);
+
+		// Zeros of cos(t), each one logged once per event
+		const std::vector<DormandPrince::EventHit>& log = dopri.eventLog();
+		REQUIRE(log.size() == 5);
+		for (size_t j = 1; j < log.size(); j++) CHECK(log[j - 1].t <= log[j].t);
+		for (const DormandPrince::EventHit& hit : log) {
+			const double n = std::round(hit.t / M_PI - 0.5);
+			CHECK(hit.t == doctest::Approx((n + 0.5) * M_PI).epsilon(1e-9));
+			CHECK(hit.Y[0] == doctest::Approx(0.0).epsilon(1e-9));
+			CHECK(hit.Y[1] == doctest::Approx(-sin(hit.t)).epsilon(1e-8));
+		}
+	}
+
+	SUBCASE("terminal event and restart") {
+		dopri.addEvent(position, 1, 1);
+		dopri.integrate(rhs, t, Y, 15.0);
+		CHECK(dopri.stopped());
+		CHECK(t == doctest::Approx(1.5 * M_PI).epsilon(1e-9));
+		CHECK(Y[1] == doctest::Approx(1.0).epsilon(1e-8));
+
+		dopri.integrate(rhs, t, Y, 15.0);
+		CHECK(dopri.stopped());
+		CHECK(t == doctest::Approx(3.5 * M_PI).epsilon(1e-9));
+
+		dopri.integrate(rhs, t, Y, 15.0);
+		CHECK_FALSE(dopri.stopped());
+		CHECK(t == 15.0);
+	}
+
+	SUBCASE("backward integration") {
+		const int id = dopri.addEvent(position, 0, 2);
+		dopri.integrate(rhs, t, Y, -10.0);
+		CHECK(dopri.stopped());
+		CHECK(dopri.eventCount(id) == 2);
+		CHECK(t == doctest::Approx(-1.5 * M_PI).epsilon(1e-9));
+	}
+
+	SUBCASE("invalid arguments") {
+		CHECK_THROWS_AS(dopri.addEvent(DormandPrince::EventFunc()), std::invalid_argument);
+		CHECK_THROWS_AS(dopri.addEvent(position, 0, -1), std::invalid_argument);
+		CHECK_THROWS_AS(dopri.eventCount(0), std::out_of_range);
+	}
+}
+
+TEST_CASE("testing rk4Ensemble function") {
+	// Oscillators with different frequencies: Y = {x, v, omega}
+	auto rhsBlock = [](const double& t, double Y[], double R[], const int& n) {
+		const double *x = Y, *v = Y + n, *omega = Y + 2 * n;
+		for (int j = 0; j < n; j++) {
+			R[j]         = v[j];
+			R[j + n]     = -omega[j] * omega[j] * x[j];
+			R[j + 2 * n] = 0.0;
+		}
+	};
+	auto rhsOne = [](const double& t, double Y[], double R[]) {
+		R[0] = Y[1];
+		R[1] = -Y[2] * Y[2] * Y[0];
+		R[2] = 0.0;
+	};
+
+	const int neq = 3, nTraj = 1000, nSteps = 200;
+	const double dt = 0.01;
+	std::vector<double> Y(neq * nTraj);
+	for (int j = 0; j < nTraj; j++) {
+		Y[j]             = 1.0;
+		Y[j + nTraj]     = 0.0;
+		Y[j + 2 * nTraj] = 0.5 + 0.001 * j;
+	}
+
+	SUBCASE("same steps as rk4Step") {
+		rk4Ensemble(0.0, Y.data(), rhsBlock, dt, nSteps, neq, nTraj, 3, 64);
+		for (int j = 0; j < nTraj; j += 37) {
+			double y[] = {1.0, 0.0, 0.5 + 0.001 * j};
+			double t = 0.0;
+			for (int s = 0; s < nSteps; s++, t += dt) rk4Step(t, y, rhsOne, dt, neq);
+			CHECK(Y[j] == doctest::Approx(y[0]).epsilon(1e-14));
+			CHECK(Y[j + nTraj] == doctest::Approx(y[1]).epsilon(1e-14));
+			CHECK(Y[j] == doctest::Approx(cos(y[2] * nSteps * dt)).epsilon(1e-7));
+		}
+	}
+
+	SUBCASE("independent of threads and block size") {
+		std::vector<double> Y2 = Y;
+		rk4Ensemble(0.0, Y.data(), rhsBlock, dt, nSteps, neq, nTraj, 1, nTraj);
+		rk4Ensemble(0.0, Y2.data(), rhsBlock, dt, nSteps, neq, nTraj, 4, 7);
+		CHECK(Y == Y2);
+	}
+
+	SUBCASE("invalid arguments") {
+		CHECK_THROWS_AS(rk4Ensemble(0.0, Y.data(), rhsBlock, dt, nSteps, 0, nTraj), std::invalid_argument);
+		CHECK_THROWS_AS(rk4Ensemble(0.0, Y.data(), rhsBlock, dt, nSteps, neq, nTraj, 0, 0), std::invalid_argument);
+	}
+}
+
 double exact1(const double& t) {
 	return exp(-0.5 * t*t);
 }
@@ -19,3 +363,17 @@ void RHS1(const double& t, double Y[], double R[]) {
 	// dy/dt = -ty
 	R[0] = -t * Y[0];
 }
+
+void RHSMany(const double& t, double Y[], double R[]) {
+	// dy_i/dt = -(i % 3) y_i
+	for (int i = 0; i < 1000; i++) R[i] = -(i % 3) * Y[i];
+}
+
+void RHSOsc(double Y[], double R[]) {
+	// Y = {x_0, ..., x_499, v_0, ..., v_499}
+	const int n = 500;
+	for (int i = 0; i < n; i++) {
+		R[i]     = Y[i + n];
+		R[i + n] = -Y[i];
+	}
+}
@@ -0,0 +1,71 @@
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "test_config.hpp"
+#include "../include/parallel.hpp"
+
+TEST_CASE("testing parallelFor function") {
+	const int n = 1000;
+	std::vector<int> visits(n, 0);
+
+	SUBCASE("every index is visited exactly once") {
+		for (int nThreads : {1, 2, 7, 0}) {
+			for (int& v : visits) v = 0;
+			parallelFor(0, n, [&](const int& i0, const int& i1) {
+				for (int i = i0; i < i1; i++) visits[i]++;
+			}, nThreads);
+
+			for (int i = 0; i < n; i++) CHECK(visits[i] == 1);
+		}
+	}
+
+	SUBCASE("more threads than indices") {
+		std::atomic<int> calls(0);
+		parallelFor(0, 3, [&](const int& i0, const int& i1) {
+			CHECK(i1 - i0 == 1);
+			calls++;
+		}, 16);
+		CHECK(calls == 3);
+	}
+
+	SUBCASE("exceptions are propagated") {
+		CHECK_THROWS_WITH_AS(parallelFor(0, n, [](const int& i0, const int& i1) {
+			if (i0 > 0) throw std::runtime_error("error in chunk");
+		}, 4), "error in chunk", std::runtime_error);
+	}
+}
+
+TEST_CASE("testing parallelForDynamic function") {
+	const int n = 1000;
+	std::vector<int> visits(n, 0);
+
+	SUBCASE("every index is visited exactly once") {
+		for (int nThreads : {1, 3, 0}) {
+			for (int grain : {1, 7, 2000}) {
+				for (int& v : visits) v = 0;
+				parallelForDynamic(0, n, [&](const int& i0, const int& i1) {
+					CHECK((i1 - i0 <= grain || (i0 == 0 && i1 == n)));
+					for (int i = i0; i < i1; i++) visits[i]++;
+				}, nThreads, grain);
+
+				for (int i = 0; i < n; i++) CHECK(visits[i] == 1);
+			}
+		}
+	}
+
+	SUBCASE("offset range") {
+		std::atomic<long> sum(0);
+		parallelForDynamic(10, 20, [&](const int& i0, const int& i1) {
+			for (int i = i0; i < i1; i++) sum += i;
+		}, 4);
+		CHECK(sum == 145);
+	}
+
+	SUBCASE("exceptions are propagated") {
+		CHECK_THROWS_WITH_AS(parallelForDynamic(0, n, [](const int& i0, const int& i1) {
+			if (i0 == 500) throw std::runtime_error("error in chunk");
+		}, 4), "error in chunk", std::runtime_error);
+		CHECK_THROWS_AS(parallelForDynamic(0, n, [](const int& i0, const int& i1) {}, 4, 0), std::invalid_argument);
+	}
+}
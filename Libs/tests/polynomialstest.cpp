@@ -41,3 +41,146 @@ TEST_CASE("testing hornerPol function") {
 		CHECK(pol == doctest::Approx(expectedPol));
 	}
 }
+
+TEST_CASE("testing hornerPol with vectors") {
+	const std::vector<double> a = {5.0, 1.0, -3.0, 1.0};
+	double dpdx;
+
+	CHECK(hornerPol(-2.7, a, dpdx) == doctest::Approx(-39.253));
+	CHECK(dpdx == doctest::Approx(39.07));
+	CHECK(hornerPol(3.14, a) == doctest::Approx(9.520344));
+
+	const std::vector<double> empty;
+	CHECK(hornerPol(2.0, empty, dpdx) == 0.0);
+	CHECK(dpdx == 0.0);
+	CHECK(hornerPol(2.0, std::vector<double>{7.0}) == 7.0);
+}
+
+TEST_CASE("testing hornerPol on many points") {
+	const double a[] = {5.0, 1.0, -3.0, 1.0};
+	const int degree = 3;
+	const int n = 1000;
+	std::vector<double> x(n), p(n), dpdx(n);
+	for (int j = 0; j < n; j++) x[j] = -3.0 + 6.0 * j / (n - 1);
+
+	hornerPol(x.data(), p.data(), dpdx.data(), n, a, degree);
+	for (int j = 0; j < n; j++) {
+		double d;
+		CHECK(p[j] == hornerPol(x[j], a, degree, d));
+		CHECK(dpdx[j] == d);
+	}
+
+	SUBCASE("in place") {
+		std::vector<double> y = x;
+		hornerPol(y.data(), y.data(), n, a, degree);
+		for (int j = 0; j < n; j++) CHECK(y[j] == p[j]);
+	}
+}
+
+TEST_CASE("testing estrinPol function") {
+	const std::vector<double> a = {5.0, 1.0, -3.0, 1.0};
+	CHECK(estrinPol(-1.0, a) == doctest::Approx(0.0));
+	CHECK(estrinPol(-2.7, a) == doctest::Approx(-39.253));
+	CHECK(estrinPol(3.14, a) == doctest::Approx(9.520344));
+
+	// Every degree up to 40, including the ones that are not powers of two
+	std::vector<double> b(41);
+	for (int i = 0; i < 41; i++) b[i] = 1.0 / (i + 1) * (i % 2 ? -1.0 : 1.0);
+	for (int degree = 0; degree <= 40; degree++) {
+		for (double x : {-0.9, -0.3, 0.0, 0.5, 0.95}) {
+			CHECK(estrinPol(x, b.data(), degree) == doctest::Approx(hornerPol(x, b.data(), degree)));
+		}
+	}
+}
+
+constexpr double cubic[] = {5.0, 1.0, -3.0, 1.0};
+
+constexpr double cubicDerivative(const double& x) {
+	double dpdx = 0.0;
+	hornerPol<3>(x, cubic, dpdx);
+	return dpdx;
+}
+
+TEST_CASE("testing hornerPol with fixed degree") {
+	// Usable in constant expressions
+	static_assert(hornerPol<3>(5.0, cubic) == 60.0, "");
+	static_assert(cubicDerivative(5.0) == 46.0, "");
+	static_assert(hornerPol<0>(2.0, cubic) == 5.0, "");
+
+	// Same result as the runtime overloads
+	for (double x : {-2.7, -1.0, 0.0, 0.3, 3.14}) {
+		double d, dFixed;
+		CHECK(hornerPol<3>(x, cubic) == hornerPol(x, cubic, 3));
+		CHECK(hornerPol<3>(x, cubic, dFixed) == hornerPol(x, cubic, 3, d));
+		CHECK(dFixed == d);
+		CHECK(hornerPol<1>(x, cubic, dFixed) == hornerPol(x, cubic, 1, d));
+		CHECK(dFixed == d);
+	}
+}
+
+/**
+ * @brief      Checks that every expected root matches a different found root.
+ */
+void checkRoots(std::vector<std::complex<double>> found, const std::vector<std::complex<double>>& expected, const double& tol) {
+	REQUIRE(found.size() == expected.size());
+	for (const std::complex<double>& r : expected) {
+		auto best = std::min_element(found.begin(), found.end(), [&](const std::complex<double>& u, const std::complex<double>& v) {
+			return std::abs(u - r) < std::abs(v - r);
+		});
+		CHECK(std::abs(*best - r) <= tol * std::max(1.0, std::abs(r)));
+		found.erase(best);
+	}
+}
+
+TEST_CASE("testing polRoots function") {
+	typedef std::complex<double> cplx;
+
+	SUBCASE("real and complex roots") {
+		// (x - 2)(x + 1)(x^2 + 1) = x^4 - x^3 - x^2 - x - 2
+		const std::vector<double> a = {-2.0, -1.0, -1.0, -1.0, 1.0};
+		checkRoots(polRoots(a), {2.0, -1.0, cplx(0.0, 1.0), cplx(0.0, -1.0)}, 1e-13);
+	}
+
+	SUBCASE("zero and multiple roots") {
+		// x^2 (x - 1)^3 = x^5 - 3x^4 + 3x^3 - x^2
+		const std::vector<double> a = {0.0, 0.0, -1.0, 3.0, -3.0, 1.0};
+		std::vector<cplx> roots = polRoots(a);
+		CHECK(roots[0] == 0.0);
+		CHECK(roots[1] == 0.0);
+		checkRoots(roots, {0.0, 0.0, 1.0, 1.0, 1.0}, 1e-4);
+	}
+
+	SUBCASE("Wilkinson-like polynomial") {
+		// (x - 1)(x - 2)...(x - 10)
+		std::vector<double> a = {1.0};
+		std::vector<cplx> expected;
+		for (int r = 1; r <= 10; r++) {
+			a.push_back(0.0);
+			for (size_t i = a.size() - 1; i > 0; i--) a[i] = a[i - 1] - r * a[i];
+			a[0] *= -r;
+			expected.push_back(r);
+		}
+		checkRoots(polRoots(a), expected, 1e-9);
+	}
+
+	SUBCASE("many polynomials") {
+		// x^3 - k x: roots 0 and +-sqrt(k)
+		const int nPol = 50, degree = 3;
+		std::vector<double> a(nPol * (degree + 1), 0.0);
+		for (int k = 0; k < nPol; k++) {
+			a[k * 4 + 1] = -(k + 1.0);
+			a[k * 4 + 3] = 1.0;
+		}
+		std::vector<cplx> roots(nPol * degree);
+		polRoots(a.data(), degree, nPol, roots.data(), 256, 4);
+		for (int k = 0; k < nPol; k++) {
+			std::vector<cplx> found(roots.begin() + k * degree, roots.begin() + (k + 1) * degree);
+			checkRoots(found, {0.0, sqrt(k + 1.0), -sqrt(k + 1.0)}, 1e-13);
+		}
+	}
+
+	SUBCASE("invalid arguments") {
+		CHECK_THROWS_AS(polRoots(std::vector<double>{1.0, 2.0, 0.0}), std::invalid_argument);
+		CHECK_THROWS_AS(polRoots(std::vector<double>{1.0}), std::invalid_argument);
+	}
+}
@@ -132,12 +132,36 @@ TEST_CASE("testing simpsonQuad function") {
 TEST_CASE("testing setLegendreWeightsAndRoots function") {
 	double weights[8], roots[8];
 
-	SUBCASE("number of gaussian points greater than max") {
-		CHECK_THROWS_WITH_AS(setLegendreWeightsAndRoots(weights, roots, 8), 
-							 "setLegendreWeightsAndRoots(): Invalid argument: Ng must be in [1, 5].",
+	SUBCASE("number of gaussian points not positive") {
+		CHECK_THROWS_WITH_AS(setLegendreWeightsAndRoots(weights, roots, 0), 
+							 "setLegendreWeightsAndRoots(): Invalid argument: Ng must be positive.",
 							 std::invalid_argument);
 	}
 
+	SUBCASE("closed forms up to Ng = 5") {
+		const double expectedRoot4[] = {sqrt(3.0 / 7.0 - 2.0 / 7.0 * sqrt(6.0 / 5.0)), sqrt(3.0 / 7.0 + 2.0 / 7.0 * sqrt(6.0 / 5.0))};
+		const double expectedWeight4[] = {(18 + sqrt(30)) / 36, (18 - sqrt(30)) / 36};
+		setLegendreWeightsAndRoots(weights, roots, 4);
+		for (int i = 0; i < 2; i++) {
+			CHECK(roots[2 * i] == doctest::Approx(expectedRoot4[i]).epsilon(1e-15));
+			CHECK(roots[2 * i + 1] == doctest::Approx(-expectedRoot4[i]).epsilon(1e-15));
+			CHECK(weights[2 * i] == doctest::Approx(expectedWeight4[i]).epsilon(1e-15));
+			CHECK(weights[2 * i + 1] == doctest::Approx(expectedWeight4[i]).epsilon(1e-15));
+		}
+
+		const double expectedRoot5[] = {0.0, 1.0 / 3.0 * sqrt(5 - 2 * sqrt(10.0 / 7.0)), 1.0 / 3.0 * sqrt(5 + 2 * sqrt(10.0 / 7.0))};
+		const double expectedWeight5[] = {128.0 / 225.0, (322.0 + 13.0 * sqrt(70.0)) / 900.0, (322.0 - 13.0 * sqrt(70.0)) / 900.0};
+		setLegendreWeightsAndRoots(weights, roots, 5);
+		CHECK(roots[0] == 0.0);
+		CHECK(weights[0] == doctest::Approx(expectedWeight5[0]).epsilon(1e-15));
+		for (int i = 1; i < 3; i++) {
+			CHECK(roots[2 * i - 1] == doctest::Approx(expectedRoot5[i]).epsilon(1e-15));
+			CHECK(roots[2 * i] == doctest::Approx(-expectedRoot5[i]).epsilon(1e-15));
+			CHECK(weights[2 * i - 1] == doctest::Approx(expectedWeight5[i]).epsilon(1e-15));
+			CHECK(weights[2 * i] == doctest::Approx(expectedWeight5[i]).epsilon(1e-15));
+		}
+	}
+
 	SUBCASE("normal operation") {
 		const double expectedRoot1 = 0.0;
 		const double expectedRoot2 = 0.577350269189626;
@@ -171,6 +195,33 @@ TEST_CASE("testing setLegendreWeightsAndRoots function") {
 	}
 }
 
+TEST_CASE("testing gaussLegendreRule function") {
+	CHECK_THROWS_AS(gaussLegendreRule(-1), std::invalid_argument);
+
+	// The rule with Ng points is exact for polynomials up to degree 2 Ng - 1
+	for (int Ng : {7, 20, 33, 64}) {
+		const GaussLegendreRule& rule = gaussLegendreRule(Ng);
+		REQUIRE(rule.roots.size() == static_cast<size_t>(Ng));
+		REQUIRE(rule.weights.size() == static_cast<size_t>(Ng));
+		CHECK(&rule == &gaussLegendreRule(Ng));
+
+		for (int k = 0; k < 2 * Ng; k += 2) {
+			double sum = 0.0;
+			for (int i = 0; i < Ng; i++) sum += rule.weights[i] * pow(rule.roots[i], k);
+			CHECK(sum == doctest::Approx(2.0 / (k + 1)).epsilon(1e-13));
+		}
+
+		// Ordering: 0 first for odd Ng, then (+x, -x) pairs by increasing |x|
+		const int first = Ng % 2;
+		if (first) CHECK(rule.roots[0] == 0.0);
+		for (int i = first; i < Ng; i += 2) {
+			CHECK(rule.roots[i] > 0.0);
+			CHECK(rule.roots[i + 1] == -rule.roots[i]);
+			if (i + 2 < Ng) CHECK(rule.roots[i + 2] > rule.roots[i]);
+		}
+	}
+}
+
 TEST_CASE("testing gaussLegendreQuad function") {
 	const int N = 1;
 	const int Ng = 3;
@@ -186,6 +237,11 @@ TEST_CASE("testing gaussLegendreQuad function") {
 		CHECK(gaussLegendreQuad(func2, xa, xb, N, Ng) == doctest::Approx(expected));
 	}
 
+	SUBCASE("high order rule on function 1: exp(-x)") {
+		CHECK(gaussLegendreQuad(func1, xa, xb, N, 20) == doctest::Approx(1.0 - exp(-3.0)).epsilon(1e-15));
+		CHECK(gaussLegendreQuad(func1, xa, xb, 4, 64) == doctest::Approx(1.0 - exp(-3.0)).epsilon(1e-15));
+	}
+
 	SUBCASE("test default gaussian points number") {
 		CHECK(gaussLegendreQuad(func2, xa, xb, N) == doctest::Approx(expected));
 	}
@@ -233,3 +289,327 @@ double func2(const double& x) {
 double func3(const double& x, const double& y) {
 	return x*x*x*x * y*y + 2.0 * x*x * y*y - x*x * y + 2.0;
 }
+
+double poly13(const double& x);
+double sqrtAbs(const double& x);
+
+TEST_CASE("testing gaussKronrodQuad function") {
+	double err;
+
+	SUBCASE("exact on polynomials") {
+		// The error estimate vanishes for polynomials that the Gauss rule
+		// integrates exactly (degree 13 for G7K15), so one interval is enough
+		for (int points : {15, 21}) {
+			CHECK(gaussKronrodQuad(poly13, -1.0, 2.0, 1e-9, err, points) == doctest::Approx(15909.0 / 14.0).epsilon(1e-14));
+			CHECK(err <= 1e-9);
+		}
+	}
+
+	SUBCASE("smooth integrand") {
+		for (int points : {15, 21}) {
+			const double I = gaussKronrodQuad(func1, 0.0, 3.0, 1e-12, err, points);
+			CHECK(I == doctest::Approx(1.0 - exp(-3.0)).epsilon(1e-14));
+			CHECK(err <= 1e-12);
+		}
+	}
+
+	SUBCASE("integrand with a cusp") {
+		// Integral of sqrt(|x|) over [-1, 2]
+		const double expected = 2.0 / 3.0 * (1.0 + pow(2.0, 1.5));
+		const double I = gaussKronrodQuad(sqrtAbs, -1.0, 2.0, 1e-10, err);
+		CHECK(err <= 1e-10);
+		CHECK(fabs(I - expected) <= 1e-10);
+	}
+
+	SUBCASE("default arguments") {
+		CHECK(gaussKronrodQuad(func2, 0.0, 3.0) == doctest::Approx(4.666666666666667));
+	}
+
+	SUBCASE("maximum number of sub-intervals") {
+		gaussKronrodQuad(sqrtAbs, -1.0, 2.0, 1e-15, err, 15, 3);
+		CHECK(err > 1e-15);
+	}
+
+	SUBCASE("invalid arguments") {
+		CHECK_THROWS_AS(gaussKronrodQuad(func1, 0.0, 1.0, 1e-10, err, 17), std::invalid_argument);
+		CHECK_THROWS_AS(gaussKronrodQuad(func1, 0.0, 1.0, 1e-10, err, 15, 0), std::invalid_argument);
+	}
+}
+
+double sqrtAbs(const double& x) {
+	return sqrt(fabs(x));
+}
+
+double poly13(const double& x) {
+	return pow(x, 13) - 2.0 * pow(x, 6) + 1.0;
+}
+
+double invSqrt(const double& x);
+double logFunc(const double& x);
+double lorentzian(const double& x);
+double gaussian(const double& x);
+
+TEST_CASE("testing double exponential quad methods") {
+	double err;
+
+	SUBCASE("tanh-sinh") {
+		CHECK(tanhSinhQuad(func1, 0.0, 3.0, 1e-12, err) == doctest::Approx(1.0 - exp(-3.0)).epsilon(1e-14));
+		CHECK(err <= 1e-12);
+
+		// Singularities at the endpoints
+		CHECK(tanhSinhQuad(invSqrt, 0.0, 1.0, 1e-12, err) == doctest::Approx(2.0).epsilon(1e-12));
+		CHECK(err <= 1e-12);
+		CHECK(tanhSinhQuad(logFunc, 0.0, 1.0, 1e-12, err) == doctest::Approx(-1.0).epsilon(1e-12));
+		CHECK(tanhSinhQuad(logFunc, 1.0, 0.0) == doctest::Approx(1.0).epsilon(1e-10));
+	}
+
+	SUBCASE("exp-sinh") {
+		CHECK(expSinhQuad(func1, 0.0, 1e-12, err) == doctest::Approx(1.0).epsilon(1e-12));
+		CHECK(err <= 1e-12);
+		CHECK(expSinhQuad(lorentzian, 0.0) == doctest::Approx(M_PI_2).epsilon(1e-10));
+		CHECK(expSinhQuad(func1, 1.0) == doctest::Approx(exp(-1.0)).epsilon(1e-10));
+	}
+
+	SUBCASE("sinh-sinh") {
+		CHECK(sinhSinhQuad(gaussian, 1e-12, err) == doctest::Approx(sqrt(M_PI)).epsilon(1e-12));
+		CHECK(err <= 1e-12);
+		CHECK(sinhSinhQuad(lorentzian) == doctest::Approx(M_PI).epsilon(1e-10));
+	}
+
+	SUBCASE("maximum level") {
+		CHECK_THROWS_AS(tanhSinhQuad(func1, 0.0, 1.0, 1e-12, err, -1), std::invalid_argument);
+		tanhSinhQuad(func1, 0.0, 1.0, 0.0, err, 2);
+		CHECK(err > 0.0);
+	}
+}
+
+double invSqrt(const double& x) {
+	return 1.0 / sqrt(x);
+}
+
+double logFunc(const double& x) {
+	return log(x);
+}
+
+double lorentzian(const double& x) {
+	return 1.0 / (1.0 + x * x);
+}
+
+double gaussian(const double& x) {
+	return exp(-x * x);
+}
+
+void func1Batch(const double x[], double fx[], const int& n);
+
+TEST_CASE("testing batch and callable integrands") {
+	const double xa = 0.0, xb = 3.0;
+	const int n = 1000;  // More nodes than a block
+
+	SUBCASE("batch function pointers") {
+		CHECK(rectangularQuad(func1Batch, xa, xb, n) == doctest::Approx(rectangularQuad(func1, xa, xb, n)).epsilon(1e-14));
+		CHECK(midpointQuad(func1Batch, xa, xb, n) == doctest::Approx(midpointQuad(func1, xa, xb, n)).epsilon(1e-14));
+		CHECK(trapezoidalQuad(func1Batch, xa, xb, n) == doctest::Approx(trapezoidalQuad(func1, xa, xb, n)).epsilon(1e-14));
+		CHECK(simpsonQuad(func1Batch, xa, xb, n) == doctest::Approx(simpsonQuad(func1, xa, xb, n)).epsilon(1e-14));
+		CHECK(gaussLegendreQuad(func1Batch, xa, xb, 100, 5) == doctest::Approx(1.0 - exp(-3.0)).epsilon(1e-14));
+		CHECK(gaussLegendreQuad(func1Batch, xa, xb) == doctest::Approx(gaussLegendreQuad(func1, xa, xb)).epsilon(1e-14));
+		CHECK_THROWS_AS(simpsonQuad(func1Batch, xa, xb, 3), std::invalid_argument);
+	}
+
+	SUBCASE("callables") {
+		const double k = 2.0;
+		auto scalar = [k](const double& x) { return exp(-k * x); };
+		int calls = 0;
+		auto batch = [k, &calls](const double x[], double fx[], const int& m) {
+			calls++;
+			for (int i = 0; i < m; i++) fx[i] = exp(-k * x[i]);
+		};
+		const double expected = (1.0 - exp(-6.0)) / k;
+
+		CHECK(gaussLegendreQuad(scalar, xa, xb, 50, 7) == doctest::Approx(expected).epsilon(1e-14));
+		CHECK(gaussLegendreQuad(batch, xa, xb, 50, 7) == doctest::Approx(expected).epsilon(1e-14));
+		CHECK(calls == 2);  // 350 nodes in blocks of 256
+		CHECK(simpsonQuad(scalar, xa, xb, n) == doctest::Approx(expected).epsilon(1e-10));
+		CHECK(trapezoidalQuad(batch, xa, xb, n) == doctest::Approx(expected).epsilon(1e-5));
+		CHECK(midpointQuad(scalar, xa, xb, n) == doctest::Approx(expected).epsilon(1e-5));
+		CHECK(rectangularQuad(batch, xa, xb, n) == doctest::Approx(rectangularQuad(scalar, xa, xb, n)).epsilon(1e-14));
+	}
+
+	SUBCASE("batch callables with std::size_t") {
+		int calls = 0;
+		auto byValue = [&calls](const double* x, double* fx, std::size_t m) {
+			calls++;
+			for (std::size_t i = 0; i < m; i++) fx[i] = exp(-x[i]);
+		};
+		auto byRef = [&calls](const double* x, double* fx, std::size_t& m) {
+			calls++;
+			for (std::size_t i = 0; i < m; i++) fx[i] = exp(-x[i]);
+		};
+		const double expected = gaussLegendreQuad(func1Batch, xa, xb, 50, 7);
+
+		CHECK(gaussLegendreQuad(byValue, xa, xb, 50, 7) == expected);
+		CHECK(calls == 2);
+		CHECK(gaussLegendreQuad(byRef, xa, xb, 50, 7) == expected);
+		CHECK(calls == 4);
+	}
+}
+
+void func1Batch(const double x[], double fx[], const int& n) {
+	for (int i = 0; i < n; i++) fx[i] = exp(-x[i]);
+}
+
+TEST_CASE("testing multithreaded quad methods") {
+	const double xa = 0.0, xb = 3.0;
+	const int n = 100000;
+
+	// Bit for bit the same result for any number of threads
+	const double rect = rectangularQuad(func2, xa, xb, n);
+	const double mid = midpointQuad(func2, xa, xb, n);
+	const double trap = trapezoidalQuad(func2, xa, xb, n);
+	const double simp = simpsonQuad(func2, xa, xb, n);
+	const double gauss = gaussLegendreQuad(func2, xa, xb, n / 5, 5);
+	const double batch = gaussLegendreQuad(func1Batch, xa, xb, n / 5, 5);
+	for (int nThreads : {2, 3, 8, 0}) {
+		CHECK(rectangularQuad(func2, xa, xb, n, nThreads) == rect);
+		CHECK(midpointQuad(func2, xa, xb, n, nThreads) == mid);
+		CHECK(trapezoidalQuad(func2, xa, xb, n, nThreads) == trap);
+		CHECK(simpsonQuad(func2, xa, xb, n, nThreads) == simp);
+		CHECK(gaussLegendreQuad(func2, xa, xb, n / 5, 5, nThreads) == gauss);
+		CHECK(gaussLegendreQuad(func1Batch, xa, xb, n / 5, 5, nThreads) == batch);
+	}
+
+	// The compensated sums keep the rounding errors from piling up
+	CHECK(fabs(simp - 14.0 / 3.0) <= 1e-14);
+	CHECK(fabs(gauss - 14.0 / 3.0) <= 1e-14);
+	CHECK(fabs(batch - (1.0 - exp(-3.0))) <= 1e-15);
+}
+
+double func3Cubic(const double& x);
+
+int rombergCalls = 0;
+
+double countedFunc1(const double& x) {
+	rombergCalls++;
+	return exp(-x);
+}
+
+TEST_CASE("testing rombergQuad function") {
+	double err;
+
+	SUBCASE("smooth integrand") {
+		rombergCalls = 0;
+		const double I = rombergQuad(countedFunc1, 0.0, 3.0, 1e-12, err);
+		CHECK(I == doctest::Approx(1.0 - exp(-3.0)).epsilon(1e-13));
+		CHECK(err <= 1e-12);
+		// Every level only adds the new midpoints: 2^k + 1 evaluations
+		CHECK(((rombergCalls - 1) & (rombergCalls - 2)) == 0);
+		CHECK(rombergCalls <= 129);
+	}
+
+	SUBCASE("exact on cubic polynomials") {
+		CHECK(rombergQuad(func3Cubic, -1.0, 2.0, 1e-14, err) == doctest::Approx(5.25).epsilon(1e-15));
+	}
+
+	SUBCASE("default tolerance") {
+		CHECK(rombergQuad(func2, 0.0, 3.0) == doctest::Approx(14.0 / 3.0).epsilon(1e-10));
+	}
+
+	SUBCASE("maximum level") {
+		rombergQuad(sqrtAbs, -1.0, 2.0, 1e-15, err, 3);
+		CHECK(err > 1e-15);
+		CHECK_THROWS_AS(rombergQuad(func1, 0.0, 1.0, 1e-10, err, 0), std::invalid_argument);
+	}
+}
+
+double func3Cubic(const double& x) {
+	return x * x * x - x + 1.0;
+}
+
+int ndCalls = 0;
+
+double ndFunc(const double x[]) {
+	return x[0] * x[0] * x[1] * exp(x[2]);
+}
+
+double ndFunc2D(const double x[]) {
+	return func3(x[0], x[1]);
+}
+
+double ndPoly(const double x[]) {
+	// Total degree 7 in 5 dimensions
+	double sum = 0.0;
+	for (int d = 0; d < 5; d++) sum += pow(x[d], 7);
+	return sum + x[0] * x[0] * x[1] * x[1] * x[2] * x[2] * x[3];
+}
+
+double ndMixed(const double x[]) {
+	return x[0] * x[0] * x[1] * x[1];
+}
+
+double ndGaussian(const double x[]) {
+	ndCalls++;
+	double r2 = 0.0;
+	for (int d = 0; d < 6; d++) r2 += x[d] * x[d];
+	return exp(-r2);
+}
+
+TEST_CASE("testing gaussLegendreQuadND function") {
+	SUBCASE("per-axis intervals and orders") {
+		const double xa[] = {0.0, 0.0, -1.0}, xb[] = {1.0, 2.0, 1.0};
+		const int N[] = {1, 2, 3}, Ng[] = {2, 1, 5};
+		const double expected = 1.0 / 3.0 * 2.0 * (exp(1.0) - exp(-1.0));
+		CHECK(gaussLegendreQuadND(ndFunc, 3, xa, xb, N, Ng) == doctest::Approx(expected).epsilon(1e-10));
+	}
+
+	SUBCASE("same as gaussLegendreQuad2D") {
+		const double xa[] = {-1.0, 0.5}, xb[] = {2.0, 1.5};
+		const int N[] = {3, 3}, Ng[] = {4, 4};
+		CHECK(gaussLegendreQuadND(ndFunc2D, 2, xa, xb, N, Ng) == doctest::Approx(gaussLegendreQuad2D(func3, -1.0, 2.0, 0.5, 1.5, 3, 4)).epsilon(1e-14));
+	}
+
+	SUBCASE("invalid arguments") {
+		const double xa[] = {0.0}, xb[] = {1.0};
+		const int N[] = {0}, Ng[] = {3};
+		CHECK_THROWS_AS(gaussLegendreQuadND(ndFunc2D, 0, xa, xb, N, Ng), std::invalid_argument);
+		CHECK_THROWS_AS(gaussLegendreQuadND(ndFunc2D, 1, xa, xb, N, Ng), std::invalid_argument);
+	}
+}
+
+TEST_CASE("testing smolyakQuad function") {
+	SUBCASE("exact for total degree 2 level - 1") {
+		const double xa[] = {0.0, 0.0, 0.0, 0.0, 0.0}, xb[] = {1.0, 1.0, 1.0, 1.0, 1.0};
+		CHECK(smolyakQuad(ndPoly, 5, xa, xb, 4) == doctest::Approx(5.0 / 8.0 + 1.0 / 54.0).epsilon(1e-14));
+	}
+
+	SUBCASE("mixed monomial") {
+		// x^2 y^2 has total degree 4: exact from level 3, while at level 2
+		// only the midpoint rule is used along the axis of one of the squares
+		const double xa[] = {-1.0, -1.0}, xb[] = {1.0, 1.0};
+		CHECK(smolyakQuad(ndMixed, 2, xa, xb, 3) == doctest::Approx(4.0 / 9.0).epsilon(1e-14));
+		CHECK(smolyakQuad(ndMixed, 2, xa, xb, 2) == doctest::Approx(0.0));
+	}
+
+	SUBCASE("fewer points than the tensor product") {
+		const double xa[] = {-1.0, -1.0, -1.0, -1.0, -1.0, -1.0}, xb[] = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+		const double expected = pow(sqrt(M_PI) * erf(1.0), 6);
+
+		ndCalls = 0;
+		const double sparse = smolyakQuad(ndGaussian, 6, xa, xb, 6);
+		const int sparseCalls = ndCalls;
+
+		ndCalls = 0;
+		const int N[] = {1, 1, 1, 1, 1, 1}, Ng[] = {6, 6, 6, 6, 6, 6};
+		const double full = gaussLegendreQuadND(ndGaussian, 6, xa, xb, N, Ng);
+		CHECK(ndCalls == 46656);
+
+		// Similar accuracy with a fifth of the points
+		CHECK(sparse == doctest::Approx(expected).epsilon(1e-4));
+		CHECK(full == doctest::Approx(expected).epsilon(1e-4));
+		CHECK(sparseCalls < ndCalls / 5);
+	}
+
+	SUBCASE("invalid arguments") {
+		const double xa[] = {0.0}, xb[] = {1.0};
+		CHECK_THROWS_AS(smolyakQuad(ndPoly, 0, xa, xb, 2), std::invalid_argument);
+		CHECK_THROWS_AS(smolyakQuad(ndPoly, 1, xa, xb, 0), std::invalid_argument);
+	}
+}
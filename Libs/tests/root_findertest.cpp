@@ -1,5 +1,6 @@
 #include <cmath>
 #include <exception>
+#include <vector>
 
 #include "test_config.hpp"
 #include "../include/root_finder.hpp"
@@ -18,6 +19,13 @@ double func4(const double& x);
 double dfunc4(const double& x);
 
 double func5(const double& x);
+
+double sinFunc(const double& x);
+double closeRoots(const double& x);
+double rootNearPole(const double& x);
+double stepFunc(const double& x);
+double flatFunc(const double& x);
+double convexFunc(const double& x);
 double dfunc5_small(const double& x);
 double dfunc5(const double& x);
 
@@ -139,6 +147,159 @@ TEST_CASE("testing falsePosition function") {
 	}
 }
 
+TEST_CASE("testing brent function") {
+	double xtol = 1.0e-7;
+	double xa = -1.0, xb = 1.0;
+
+	double root = 0.0;
+
+	SUBCASE("testing exceptions") {
+		CHECK_THROWS_WITH_AS(brent(func1, xa, -xb, xtol, root),
+							 "The supplied interval does not contain any roots.",
+							 std::runtime_error);
+	}
+
+	SUBCASE("roots of func1") {
+		const double expected = 5.671433e-01;
+
+		brent(func1, xa, xb, xtol, root);
+		CHECK(root == doctest::Approx(expected));
+
+		int nTry = 0;
+		brent(func1, xa, xb, xtol, root, nTry);
+		CHECK(root == doctest::Approx(expected));
+		CHECK(nTry == 5);
+
+		// Inverse quadratic interpolation converges superlinearly: full
+		// precision costs no extra step, false position needs 32
+		brent(func1, xa, xb, 1.0e-15, root, nTry);
+		CHECK(root == doctest::Approx(0.56714329040978387).epsilon(1e-15));
+		CHECK(nTry == 5);
+
+		int nTryFtol = 0;
+		brent(func1, xa, xb, xtol, 0.5, root, nTryFtol);
+		CHECK(nTryFtol <= nTry);
+	}
+
+	SUBCASE("roots of func2") {
+		xtol = 1.0e-8;
+		xa = -5.0; xb = 0.0;
+		const double expected = -1.0;
+
+		int nTry = 0;
+		brent(func2, xa, xb, xtol, root, nTry);
+		CHECK(root == doctest::Approx(expected));
+		CHECK(nTry == 10);
+	}
+
+	SUBCASE("roots of func3") {
+		xa = 0.0; xb = 2.0;
+		const double expected = 5.235934e-01;
+
+		int nTry = 0;
+		brent(func3, xa, xb, xtol, root, nTry);
+		CHECK(root == doctest::Approx(expected));
+		CHECK(nTry == 9);
+	}
+
+	SUBCASE("bisection fallback on a step function") {
+		// Interpolation is useless when |f| is constant; every step bisects
+		int nTry = 0;
+		brent(stepFunc, xa, xb, xtol, root, nTry);
+		CHECK(fabs(root - 1.0 / 3) < xtol);
+		CHECK(nTry == 25);
+
+		int nBisection = 0;
+		bisection(stepFunc, xa, xb, xtol, root, nBisection);
+		CHECK(nTry <= nBisection);
+	}
+
+	SUBCASE("bisection fallback on a flat function") {
+		// Interpolation crawls towards a root of multiplicity 9, and is
+		// replaced by bisection; false position and Illinois do not converge
+		int nTry = 0;
+		brent(flatFunc, xa, xb, xtol, root, nTry);
+		CHECK(fabs(root - 1.0 / 3) < xtol);
+		CHECK(nTry == 64);
+
+		CHECK_THROWS_WITH_AS(falsePosition(flatFunc, xa, xb, xtol, root),
+							 "Maximum number of steps exceeded.",
+							 std::runtime_error);
+	}
+}
+
+TEST_CASE("testing illinois function") {
+	double xtol = 1.0e-7;
+	double xa = -1.0, xb = 1.0;
+
+	double root = 0.0;
+
+	SUBCASE("testing exceptions") {
+		CHECK_THROWS_WITH_AS(illinois(func1, xa, -xb, xtol, root),
+							 "The supplied interval does not contain any roots.",
+							 std::runtime_error);
+	}
+
+	SUBCASE("roots of func1") {
+		const double expected = 5.671433e-01;
+
+		illinois(func1, xa, xb, xtol, root);
+		CHECK(root == doctest::Approx(expected));
+
+		int nTry = 0;
+		illinois(func1, xa, xb, xtol, root, nTry);
+		CHECK(root == doctest::Approx(expected));
+		CHECK(nTry == 8);
+
+		// Both ends move, so the interval shrinks to the full precision
+		// within the same steps; false position needs 32
+		illinois(func1, xa, xb, 1.0e-15, root, nTry);
+		CHECK(root == doctest::Approx(0.56714329040978387).epsilon(1e-15));
+		CHECK(nTry == 8);
+
+		int nTryFtol = 0;
+		illinois(func1, xa, xb, xtol, 0.5, root, nTryFtol);
+		CHECK(nTryFtol <= nTry);
+	}
+
+	SUBCASE("roots of func2") {
+		// False position keeps the end at 0 for 80 steps
+		xtol = 1.0e-8;
+		xa = -5.0; xb = 0.0;
+		const double expected = -1.0;
+
+		int nTry = 0;
+		illinois(func2, xa, xb, xtol, root, nTry);
+		CHECK(root == doctest::Approx(expected));
+		CHECK(nTry == 11);
+	}
+
+	SUBCASE("roots of func3") {
+		// False position keeps the end at 2 for 55 steps
+		xa = 0.0; xb = 2.0;
+		const double expected = 5.235934e-01;
+
+		int nTry = 0;
+		illinois(func3, xa, xb, xtol, root, nTry);
+		CHECK(root == doctest::Approx(expected));
+		CHECK(nTry == 11);
+	}
+
+	SUBCASE("stalled end of false position") {
+		// On a convex function the upper end never moves, and false position
+		// exceeds the maximum number of steps
+		xa = 0.0; xb = 1.5;
+		CHECK_THROWS_WITH_AS(falsePosition(convexFunc, xa, xb, xtol, root),
+							 "Maximum number of steps exceeded.",
+							 std::runtime_error);
+
+		int nTry = 0;
+		illinois(convexFunc, xa, xb, xtol, root, nTry);
+		CHECK(root == doctest::Approx(pow(0.5, 0.1)));
+		CHECK(nTry == 15);
+	}
+}
+
 TEST_CASE("testing secant function") {
 	double xtol;
 	double xa, xb;
@@ -278,6 +439,17 @@ TEST_CASE("testing bracket function") {
 		CHECK(xL[i] == doctest::Approx(xLExpected[i]));
 		CHECK(xR[i] == doctest::Approx(xRExpected[i]));
 	}
+
+	// Same brackets when the grid is evaluated by several threads
+	double xLPar[8], xRPar[8];
+	int nRootsPar;
+	bracket(func4, xa, xb, xLPar, xRPar, N, nRootsPar, 3);
+
+	REQUIRE(nRootsPar == nRoots);
+	for (int i = 0; i < nRoots; i++) {
+		CHECK(xLPar[i] == xL[i]);
+		CHECK(xRPar[i] == xR[i]);
+	}
 }
 
 TEST_CASE("testing findRoots function") {
@@ -325,6 +497,106 @@ TEST_CASE("testing findRoots function") {
 			CHECK(roots[i] == doctest::Approx(rootsExpected[i]));
 		}
 	}
+
+	SUBCASE("testing RootMethod overloads") {
+		for (RootMethod method : {RootMethod::bisection, RootMethod::falsePosition,
+		                          RootMethod::brent, RootMethod::illinois}) {
+			findRoots(func4, xa, xb, tol, roots, nRoots, N, method, 3);
+
+			REQUIRE(nRoots == nRootsExpected);
+			for (int i = 0; i < nRoots; i++) {
+				CHECK(roots[i] == doctest::Approx(rootsExpected[i]));
+			}
+		}
+
+		findRoots(func4, dfunc4, xa, xb, tol, roots, nRoots, N, RootMethod::newton, 2);
+		REQUIRE(nRoots == nRootsExpected);
+		for (int i = 0; i < nRoots; i++) {
+			CHECK(roots[i] == doctest::Approx(rootsExpected[i]));
+		}
+
+		CHECK(rootMethod("falsePosition") == RootMethod::falsePosition);
+		CHECK_THROWS_AS(findRoots(func4, xa, xb, tol, roots, nRoots, N, RootMethod::newton),
+						std::invalid_argument);
+	}
+
+	SUBCASE("testing parallel sweep") {
+		double rootsSeq[8];
+		int nRootsSeq;
+		findRoots(func4, xa, xb, tol, rootsSeq, nRootsSeq, 100, "secant");
+		findRoots(func4, xa, xb, tol, roots, nRoots, 100, "secant", 4);
+
+		REQUIRE(nRoots == nRootsSeq);
+		for (int i = 0; i < nRoots; i++) CHECK(roots[i] == rootsSeq[i]);
+
+		findRoots(func4, dfunc4, xa, xb, tol, roots, nRoots, N, "newton", 0);
+		REQUIRE(nRoots == nRootsExpected);
+		for (int i = 0; i < nRoots; i++) {
+			CHECK(roots[i] == doctest::Approx(rootsExpected[i]));
+		}
+
+		CHECK_THROWS_WITH_AS(findRoots(func1, -10.0, 10.0, tol, roots, nRoots, N, "gobble", 3),
+							 "Invalid method argument.",
+							 std::invalid_argument);
+	}
+}
+
+TEST_CASE("testing findRoots without limits") {
+	const double tol = 1.0e-10;
+
+	SUBCASE("array version with more than 128 sub-intervals") {
+		std::vector<double> roots(1000);
+		int nRoots;
+		findRoots(sinFunc, 0.5, 1000.0, tol, roots.data(), nRoots, 1000, "brent");
+
+		REQUIRE(nRoots == 318);
+		for (int k = 0; k < nRoots; k++) CHECK(roots[k] == doctest::Approx((k + 1) * M_PI));
+	}
+
+	SUBCASE("vector version") {
+		const std::vector<double> roots = findRoots(sinFunc, 0.5, 1000.0, tol, 1000, RootMethod::brent, 0, 3);
+
+		REQUIRE(roots.size() == 318);
+		for (size_t k = 0; k < roots.size(); k++) CHECK(roots[k] == doctest::Approx((k + 1) * M_PI));
+
+		CHECK(findRoots(func1, 5.0, 10.0, tol).empty());
+		CHECK_THROWS_AS(findRoots(func1, 0.0, 1.0, tol, 0), std::invalid_argument);
+	}
+
+	SUBCASE("adaptive bracketing") {
+		// The roots 0.53 and 0.56 fall in the same sub-interval
+		std::vector<double> xL, xR;
+		bracketAdaptive(closeRoots, 0.0, 1.0, xL, xR, 10, 0);
+		CHECK(xL.empty());
+
+		bracketAdaptive(closeRoots, 0.0, 1.0, xL, xR, 10, 4);
+		REQUIRE(xL.size() == 2);
+		CHECK(xL[0] <= 0.53);
+		CHECK(xR[0] >= 0.53);
+		CHECK(xL[1] <= 0.56);
+		CHECK(xR[1] >= 0.56);
+
+		const std::vector<double> roots = findRoots(closeRoots, 0.0, 1.0, tol, 10, RootMethod::illinois, 4);
+		REQUIRE(roots.size() == 2);
+		CHECK(roots[0] == doctest::Approx(0.53));
+		CHECK(roots[1] == doctest::Approx(0.56));
+	}
+
+	SUBCASE("adaptive bracketing where f changes rapidly") {
+		// A root and a pole fall in [0.5, 0.6], where f is large and steep
+		const double root = (25.0 + sqrt(625.0 + 64.0)) / 100.0;
+		std::vector<double> xL, xR;
+		bracketAdaptive(rootNearPole, 0.0, 1.0, xL, xR, 10, 0);
+		CHECK(xL.empty());
+
+		bracketAdaptive(rootNearPole, 0.0, 1.0, xL, xR, 10, 4);
+		REQUIRE(xL.size() == 2);
+		CHECK(xL[0] <= root);
+		CHECK(xR[0] >= root);
+		CHECK(xR[0] < 0.52);
+		CHECK(xL[1] <= 0.52);
+		CHECK(xR[1] >= 0.52);
+	}
 }
 
 double func1(const double& x) {
@@ -378,3 +650,27 @@ double dfunc5_small(const double& x) {
 double dfunc5(const double& x) {
 	return 2.0 * x;
 }
+
+double sinFunc(const double& x) {
+	return sin(x);
+}
+
+double closeRoots(const double& x) {
+	return (x - 0.53) * (x - 0.56);
+}
+
+double rootNearPole(const double& x) {
+	return 1.0 + 50.0 * x + 0.2 / (x - 0.52);
+}
+
+double stepFunc(const double& x) {
+	return x < 1.0 / 3 ? -1.0 : 1.0;
+}
+
+double flatFunc(const double& x) {
+	return pow(x - 1.0 / 3, 9);
+}
+
+double convexFunc(const double& x) {
+	return pow(x, 10) - 0.5;
+}
@@ -13,6 +13,7 @@
 #include "../../Libs/include/ode_solver.hpp"
 #include "../../Libs/include/root_finder.hpp"
 
+#include <atomic>
 #include <cmath>
 #include <fstream>
 #include <iostream>
@@ -23,9 +24,10 @@ using std::cout;
 using std::endl;
 
 #define FRICTION 1
+#define ADAPTIVE 0  //!< 1: Residual with Dormand-Prince and an event at x = xTarg
 const static int gOrder = 2;  //<! Selects order of polynomial interpolation
 
-int numIntegrations = 0;  //!< Number of integrations of the ODEs performed
+std::atomic<int> numIntegrations(0);  //!< Number of integrations of the ODEs performed
 
 double g_dt = 1.0e-5;
 
@@ -35,13 +37,11 @@ const static double B     = 4.0e-5;  //!< Drag coefficient [kg/m]
 const static double V0    = 9.90;    //!< Initial velocity [m/s]
 const static double L     = 10.0;    //!< Target distance  [m]
 const static double YTarg = -0.2;    //!< Target height    [m]
-double gTheta;                       //!< Initial launch angle
 #else
 const static double B     = 0.0;   //!< Drag coefficient [kg/m]
 const static double V0    = 10.0;  //!< Initial velocity [m/s]
 const static double L     = 10.0;  //!< Target distance  [m]
 const static double YTarg = 0.0;   //!< Target height    [m]
-double gTheta;                     //!< Initial launch angle
 #endif
 
 // Dimensional factors
@@ -88,6 +88,8 @@ double linearInterp(const double &x, const double &x1, const double &y1,
  * @param[in] order     The order or the polynomial.
  *
  * @return    The interpolated line evaluated at x.
+ *
+ * @throws    exception  Thrown if `order` is larger than gOrder.
  */
 double polInterp(const double &x, double xLast[], double yLast[],
                  const double &xCurrent, const double &yCurrent,
@@ -98,6 +100,8 @@ double polInterp(const double &x, double xLast[], double yLast[],
  *
  * @param[in] roots   Array with the roots found.
  * @param[in] nRoots  Number of roots found.
+ *
+ * @throws    exception  Thrown with ADAPTIVE 1, where gOrder is not used.
  */
 void interpolationOrderErrorPlot(double roots[], const int &nRoots);
 
@@ -127,6 +131,8 @@ double exact(const double &x, const int &solNumber);
  * @param[in] dt_0     The first (and largest) value of dt.
  * @param[in] nPoints  The number of dts to explore.
  * @param[in] factor   The factor that scales dt.
+ *
+ * @throws    exception  Thrown with ADAPTIVE 1, where g_dt is not used.
  */
 void convergence(const double &dt_0, const int &nPoints,
                  const double factor = 0.5);
@@ -271,7 +277,7 @@ int main() {
 	int nRoots = -1;
 	try {
 		findRoots(Residual, thetaMin, thetaMax, thetaTol, roots, nRoots, 4,
-		          "secant");
+		          "brent", 0);
 
 		cout << "Integrations performed: " << numIntegrations << endl;
 
@@ -339,34 +345,24 @@ double linearInterp(const double &x, const double &x1, const double &y1,
 double polInterp(const double &x, double xLast[], double yLast[],
                  const double &xCurrent, const double &yCurrent,
                  const int &order) {
+	if (order > gOrder) throw exception("order must be at most gOrder.");
 	const int nPoints = order + 1;
 
-	double **M;
-	M    = new double *[nPoints];
-	M[0] = new double[nPoints * nPoints];
-	for (int i = 1; i < nPoints; i++) M[i] = M[i - 1] + nPoints;
-
-	double *v;
-	v = new double[nPoints];
-
-	// Define coefficient matrix
+	// Define coefficient matrix (row-major Vandermonde) and constant vector,
+	// on the stack since this runs in every residual evaluation
+	double M[(gOrder + 1) * (gOrder + 1)], coeffs[gOrder + 1];
+	int piv[gOrder + 1];
 	for (int i = 0; i < nPoints; i++) {
-		M[i][nPoints - 1] = 1;
-		if (i != nPoints - 1) v[i] = yLast[i];
-		else v[i] = yCurrent;
+		const double xi              = (i != nPoints - 1) ? xLast[i] : xCurrent;
+		M[i * nPoints + nPoints - 1] = 1;
+		coeffs[i]                    = (i != nPoints - 1) ? yLast[i] : yCurrent;
 		for (int j = nPoints - 2; j >= 0; j--)
-			if (i != nPoints - 1) M[i][j] = M[i][j + 1] * xLast[i];
-			else M[i][j] = M[i][j + 1] * xCurrent;
+			M[i * nPoints + j] = M[i * nPoints + j + 1] * xi;
 	}
 
-	double *coeffs;  //<! Array with the coefficients of the polynomial
-	coeffs = new double[nPoints];
-
-	solveLinSystem(M, v, coeffs, nPoints);
-
-	delete[] M[0];
-	delete[] M;
-	delete[] v;
+	// Coefficients of the polynomial (factorized and solved in place)
+	luDecomposition(M, piv, nPoints);
+	luSolve(M, piv, coeffs, coeffs, nPoints);
 
 	double value    = 0.0;
 	double powerOfX = 1.0;
@@ -379,6 +375,9 @@ double polInterp(const double &x, double xLast[], double yLast[],
 }
 
 void interpolationOrderErrorPlot(double roots[], const int &nRoots) {
+#if ADAPTIVE
+	throw exception("The interpolation order is not used with ADAPTIVE 1.");
+#endif
 	std::ofstream interp;
 	interp.open("data/interpolationOrder.csv", std::ios_base::app);
 	for (int i = 0; i < nRoots; i++) {
@@ -411,6 +410,9 @@ double exact(const double &x, const int &solNumber) {
 }
 
 void convergence(const double &dt_0, const int &nPoints, const double factor) {
+#if ADAPTIVE
+	throw exception("dt is not used with ADAPTIVE 1.");
+#endif
 	double store_g_dt = g_dt;
 	g_dt              = dt_0;
 	std::ofstream conv;
@@ -428,7 +430,7 @@ void convergence(const double &dt_0, const int &nPoints, const double factor) {
 		int nRoots = -1;
 		try {
 			findRoots(Residual, thetaMin, thetaMax, thetaTol, roots, nRoots, 4,
-			          "secant");
+			          "secant", 0);
 
 			conv.precision(12);
 			conv << g_dt << "," << roots[0] << "," << roots[1] << endl;
@@ -564,6 +566,20 @@ void integration(void (*RHSFunc)(const double &t, double *Y, double *RHS),
 }
 
 double Residual(const double &theta) {
+#if ADAPTIVE
+	// Stop exactly at x = xTarg, located on the continuous extension
+	DormandPrince dopri(4, 1.0e-12, 1.0e-12);
+	dopri.addEvent([](const double &t, const double Y[]) { return Y[0] - xTarg; },
+	               1, 1);
+
+	double y[] = {0.0, 0.0, v0 * cos(theta), v0 * sin(theta)};
+	double t   = 0.0;
+	numIntegrations++;
+	dopri.integrate(RHS, t, y, 2.0);
+	if (!dopri.stopped()) throw exception("Target distance not reached.");
+
+	return y[1] - yTarg;
+#else
 	double y[4];
 	double xLast[64], yLast[64];
 	if (gOrder > 64) throw exception("gOrder must be at most 64.");
@@ -572,4 +588,5 @@ double Residual(const double &theta) {
 	double xCurrent = y[0], yCurrent = y[1];
 
 	return polInterp(xTarg, xLast, yLast, xCurrent, yCurrent, gOrder) - yTarg;
+#endif
 }